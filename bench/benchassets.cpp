@@ -0,0 +1,70 @@
+#include <SDL.h>
+#include <stdio.h>
+#include <vector>
+#include "vyengine.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+static const char* BenchImagePath = "img/helloworld.png";
+
+/// <summary>
+/// the whole load happens inside one frame, so the stall is the total.
+/// each texture is released right away, otherwise the texture cache would share the first load
+/// </summary>
+static bool RunSync(VyEngine& engine, int count) {
+	BenchSamples stall;
+	BenchTimePoint t0 = BenchClock::now();
+	for (int i = 0; i < count; ++i) {
+		SDL_Texture* texture = NULL;
+		if (engine.LoadSdlTexture(BenchImagePath, texture) != VyEngine::ErrorCode::Success) {
+			fprintf(stderr, "skipping assets: %s", engine.ErrorMessage.c_str());
+			engine.ErrorMessage = "";
+			return false;
+		}
+		engine.ReleaseSdlTexture(texture);
+	}
+	stall.Add(t0, BenchClock::now());
+	stall.PrintRow("assets-sync", count, "Load");
+	return true;
+}
+
+/// <summary>
+/// submits everything, then runs frames that only finish uploads within the engine's budget, until all are done
+/// </summary>
+static void RunAsync(VyEngine& engine, int count) {
+	BenchSamples submit, frame, total;
+	BenchTimePoint t0 = BenchClock::now();
+	std::vector<VyAssetHandle> handles;
+	handles.reserve(count);
+	for (int i = 0; i < count; ++i) {
+		handles.push_back(engine.LoadSdlTextureAsync(BenchImagePath));
+	}
+	BenchTimePoint t1 = BenchClock::now();
+	submit.Add(t0, t1);
+	int done = 0;
+	while (done < count) {
+		BenchTimePoint frameStart = BenchClock::now();
+		engine.ProcessAssetUploads(engine.AssetUploadBudget);
+		frame.Add(frameStart, BenchClock::now());
+		while (done < count && handles[done].IsDone()) {
+			++done;
+		}
+		// stand-in for the rest of a frame, so workers get time to decode
+		SDL_Delay(1);
+	}
+	total.Add(t0, BenchClock::now());
+	for (int i = 0; i < count; ++i) {
+		engine.ReleaseSdlTexture(handles[i].GetTexture());
+	}
+	submit.PrintRow("assets-async", count, "Submit");
+	frame.PrintRow("assets-async", count, "UploadFrame");
+	total.PrintRow("assets-async", count, "Total");
+}
+
+void RunAssetBenchmark(int count, const BenchSettings& settings) {
+	VyEngine& engine = *VyEngine::GetInstance();
+	if (RunSync(engine, count)) {
+		RunAsync(engine, count);
+	}
+	fflush(stdout);
+}
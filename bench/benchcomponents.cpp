@@ -0,0 +1,116 @@
+#include <SDL.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include "componentcontainer.h"
+#include "sdlgameobject.h"
+#include "vycomponentstore.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+/// <summary>
+/// the simplest moving thing, as a VyComponentContainer component: a heap object with a virtual Update
+/// </summary>
+class BenchMover : public VyObjectCommonBase, public VyUpdatable {
+public:
+	float x, y, vx, vy;
+	BenchMover(float vx, float vy) : VyObjectCommonBase("mover"), x(0), y(0), vx(vx), vy(vy) {}
+	virtual VyUpdatable* AsUpdatable() { return this; }
+	virtual bool IsParallelSafe() const { return true; }
+	virtual void Update() {
+		x += vx;
+		y += vy;
+	}
+};
+
+/// <summary>
+/// the same data as BenchMover, as components of a VyComponentStore
+/// </summary>
+struct BenchPosition { float x, y; };
+struct BenchVelocity { float x, y; };
+
+static void MoveBatch(int count, BenchPosition* position, const BenchVelocity* velocity) {
+	for (int i = 0; i < count; ++i) {
+		position[i].x += velocity[i].x;
+		position[i].y += velocity[i].y;
+	}
+}
+
+void RunComponentBenchmark(int count, const BenchSettings& settings) {
+	// added in shuffled order, so consecutive components aren't neighbors on the heap, as in a scene built up over time
+	std::vector<int> order(count);
+	for (int i = 0; i < count; ++i) { order[i] = i; }
+	std::shuffle(order.begin(), order.end(), std::mt19937(1234));
+	std::vector<std::shared_ptr<BenchMover>> movers(count);
+	for (int i = 0; i < count; ++i) {
+		movers[i] = std::make_shared<BenchMover>((float)(i % 7), (float)(i % 5));
+	}
+	VyComponentContainer container;
+	for (int i = 0; i < count; ++i) {
+		container.AddComponent(movers[order[i]]);
+	}
+	movers.clear();
+
+	VyComponentStore<BenchPosition, BenchVelocity> store;
+	store.Reserve(count);
+	for (int i = 0; i < count; ++i) {
+		store.Create({ 0, 0 }, { (float)(i % 7), (float)(i % 5) });
+	}
+	VyComponentSystem<VyComponentStore<BenchPosition, BenchVelocity>, BenchPosition, BenchVelocity> system(store,
+		[](int n, BenchPosition* position, BenchVelocity* velocity) { MoveBatch(n, position, velocity); });
+
+	BenchSamples legacy, each, batch;
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		BenchTimePoint t0 = BenchClock::now();
+		container.Update();
+		BenchTimePoint t1 = BenchClock::now();
+		store.ForEach<BenchPosition, BenchVelocity>([](BenchPosition& position, BenchVelocity& velocity) {
+			position.x += velocity.x;
+			position.y += velocity.y;
+		});
+		BenchTimePoint t2 = BenchClock::now();
+		system.Update();
+		BenchTimePoint t3 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		legacy.Add(t0, t1);
+		each.Add(t1, t2);
+		batch.Add(t2, t3);
+	}
+	legacy.PrintRow("components-container", count, "Update");
+	each.PrintRow("components-store", count, "ForEach");
+	batch.PrintRow("components-store", count, "System");
+	fflush(stdout);
+}
+
+void RunSpawnBenchmark(int count, const BenchSettings& settings) {
+	BenchSamples heap, pooled;
+	std::vector<std::shared_ptr<SdlGameObject>> objects;
+	objects.reserve(count);
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		// a wave of count objects with two components each, spawned and despawned in one frame
+		BenchTimePoint t0 = BenchClock::now();
+		for (int i = 0; i < count; ++i) {
+			std::shared_ptr<SdlGameObject> object(new SdlGameObject("spawned"));
+			object->AddComponent(std::shared_ptr<BenchMover>(new BenchMover(1, 0)));
+			object->AddComponent(std::shared_ptr<BenchMover>(new BenchMover(0, 1)));
+			objects.push_back(object);
+		}
+		objects.clear();
+		BenchTimePoint t1 = BenchClock::now();
+		for (int i = 0; i < count; ++i) {
+			std::shared_ptr<SdlGameObject> object = SdlGameObject::Spawn("spawned");
+			object->AddComponent<BenchMover>(1.0f, 0.0f);
+			object->AddComponent<BenchMover>(0.0f, 1.0f);
+			objects.push_back(object);
+		}
+		objects.clear();
+		BenchTimePoint t2 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		heap.Add(t0, t1);
+		pooled.Add(t1, t2);
+	}
+	heap.PrintRow("spawn-heap", count, "SpawnDespawn");
+	pooled.PrintRow("spawn-pool", count, "SpawnDespawn");
+	fflush(stdout);
+}
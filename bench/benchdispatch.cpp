@@ -0,0 +1,88 @@
+#include <SDL.h>
+#include <map>
+#include <functional>
+#include <vector>
+#include "vydelegatetable.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+// the structure VyEngine used before VyDelegateTable, kept here as the baseline
+typedef std::function<void(SDL_Event)> LegacyDelegate;
+typedef std::map<int, std::map<size_t, LegacyDelegate>> LegacyDelegateMap;
+
+static void LegacyDispatch(LegacyDelegateMap& delegates, int id, const SDL_Event& e) {
+	auto found = delegates.find(id);
+	if (found == delegates.end()) { return; }
+	for (auto it = found->second.begin(); it != found->second.end(); ++it) {
+		it->second(e);
+	}
+}
+
+/// <summary>
+/// every owner bound to one code (like each Button binding the main click), or owners spread over 64 keycodes
+/// </summary>
+static int CodeFor(int owner, bool spread) {
+	return spread ? 32 + (owner % 64) : SDL_BUTTON_LEFT;
+}
+
+static void RunLegacy(const char* scene, int owners, bool spread, const BenchSettings& settings) {
+	BenchSamples registration, dispatch, unregistration;
+	LegacyDelegateMap delegates;
+	std::vector<char> objects(owners);
+	volatile int calls = 0;
+	BenchTimePoint t0 = BenchClock::now();
+	for (int i = 0; i < owners; ++i) {
+		delegates[CodeFor(i, spread)][(size_t)&objects[i]] = [&calls](SDL_Event e) { calls = calls + 1; };
+	}
+	registration.Add(t0, BenchClock::now());
+	SDL_Event e = {};
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		BenchTimePoint t1 = BenchClock::now();
+		LegacyDispatch(delegates, CodeFor(f, spread), e);
+		BenchTimePoint t2 = BenchClock::now();
+		if (f >= settings.warmup) { dispatch.Add(t1, t2); }
+	}
+	t0 = BenchClock::now();
+	for (int i = 0; i < owners; ++i) {
+		delegates[CodeFor(i, spread)].erase((size_t)&objects[i]);
+	}
+	unregistration.Add(t0, BenchClock::now());
+	registration.PrintRow(scene, owners, "Register");
+	dispatch.PrintRow(scene, owners, "Dispatch");
+	unregistration.PrintRow(scene, owners, "Unregister");
+}
+
+static void RunTable(const char* scene, int owners, bool spread, const BenchSettings& settings) {
+	BenchSamples registration, dispatch, unregistration;
+	VyDelegateTable delegates(spread ? VyDelegateTable::Kind::Keycode : VyDelegateTable::Kind::MouseButton);
+	std::vector<char> objects(owners);
+	volatile int calls = 0;
+	BenchTimePoint t0 = BenchClock::now();
+	for (int i = 0; i < owners; ++i) {
+		delegates.Register(CodeFor(i, spread), (size_t)&objects[i], [&calls](const SDL_Event& e) { calls = calls + 1; });
+	}
+	registration.Add(t0, BenchClock::now());
+	SDL_Event e = {};
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		BenchTimePoint t1 = BenchClock::now();
+		delegates.Dispatch(CodeFor(f, spread), e);
+		BenchTimePoint t2 = BenchClock::now();
+		if (f >= settings.warmup) { dispatch.Add(t1, t2); }
+	}
+	t0 = BenchClock::now();
+	for (int i = 0; i < owners; ++i) {
+		delegates.Unregister(CodeFor(i, spread), (size_t)&objects[i]);
+	}
+	unregistration.Add(t0, BenchClock::now());
+	registration.PrintRow(scene, owners, "Register");
+	dispatch.PrintRow(scene, owners, "Dispatch");
+	unregistration.PrintRow(scene, owners, "Unregister");
+}
+
+void RunDispatchBenchmark(int owners, const BenchSettings& settings) {
+	RunLegacy("dispatch-map-onecode", owners, false, settings);
+	RunTable("dispatch-table-onecode", owners, false, settings);
+	RunLegacy("dispatch-map-spread", owners, true, settings);
+	RunTable("dispatch-table-spread", owners, true, settings);
+	fflush(stdout);
+}
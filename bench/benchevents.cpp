@@ -0,0 +1,90 @@
+#include <SDL.h>
+#include <memory>
+#include <vector>
+#include "vyengine.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+/// <summary>
+/// a widget that only cares about keys, like every SelectableRect
+/// </summary>
+class BenchKeyListener : public VyEventProcessor {
+public:
+	int keys;
+	BenchKeyListener() : keys(0) {}
+	virtual void HandleEvent(const SDL_Event& e) {
+		if (e.type == SDL_KEYDOWN) { ++keys; }
+	}
+	virtual Uint32 GetEventMask() const { return Mask(EventCategory::Keyboard); }
+};
+
+// how VyEngine delivered events before masks and bulk draining, kept here as the baseline
+static void LegacyDeliver(std::vector<VyEventProcessor*> eventProcessors, const SDL_Event& e) {
+	for (int i = 0; i < eventProcessors.size(); ++i) {
+		eventProcessors[i]->HandleEvent(e);
+	}
+}
+
+/// <summary>
+/// a fast mouse: motionCount motion events, then a key press
+/// </summary>
+static void PushBurst(int frame, int motionCount) {
+	for (int i = 0; i < motionCount; ++i) {
+		SDL_Event motion = {};
+		motion.type = SDL_MOUSEMOTION;
+		motion.motion.x = (frame * 7 + i) % 640;
+		motion.motion.y = (frame * 3 + i) % 480;
+		motion.motion.xrel = 1;
+		motion.motion.yrel = 1;
+		SDL_PushEvent(&motion);
+	}
+	SDL_Event key = {};
+	key.type = SDL_KEYDOWN;
+	key.key.state = SDL_PRESSED;
+	key.key.keysym.sym = SDLK_a;
+	key.key.keysym.scancode = SDL_SCANCODE_A;
+	SDL_PushEvent(&key);
+	key.type = SDL_KEYUP;
+	key.key.state = SDL_RELEASED;
+	SDL_PushEvent(&key);
+}
+
+void RunEventBenchmark(int count, const BenchSettings& settings) {
+	const int motionPerFrame = 100;
+	VyEngine* engine = VyEngine::GetInstance();
+	std::vector<std::unique_ptr<BenchKeyListener>> listeners(count);
+	std::vector<VyEventProcessor*> processors(count);
+	for (int i = 0; i < count; ++i) {
+		listeners[i].reset(new BenchKeyListener());
+		processors[i] = listeners[i].get();
+	}
+	BenchSamples legacy, masked;
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		PushBurst(f, motionPerFrame);
+		BenchTimePoint t0 = BenchClock::now();
+		SDL_Event e;
+		while (SDL_PollEvent(&e)) {
+			LegacyDeliver(processors, e);
+		}
+		BenchTimePoint t1 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		legacy.Add(t0, t1);
+	}
+	for (int i = 0; i < count; ++i) {
+		engine->RegisterProcessor(processors[i]);
+	}
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		PushBurst(f, motionPerFrame);
+		BenchTimePoint t0 = BenchClock::now();
+		engine->ProcessInput();
+		BenchTimePoint t1 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		masked.Add(t0, t1);
+	}
+	for (int i = 0; i < count; ++i) {
+		engine->UnregisterProcessor(processors[i]);
+	}
+	legacy.PrintRow("events-legacy", count, "ProcessInput");
+	masked.PrintRow("events-masked", count, "ProcessInput");
+	fflush(stdout);
+}
@@ -0,0 +1,59 @@
+#include <SDL.h>
+#include <stdio.h>
+#include <vector>
+#include <algorithm>
+#include "vyengine.h"
+#include "vyfontcache.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+static const char* BenchFontName = "arial";
+
+/// <summary>
+/// count switches, round robin over the sizes, so a budget smaller than all of them evicts on every switch
+/// </summary>
+static void RunSwitches(VyEngine& engine, const char* scene, int count, const std::vector<VyEngine::FontId>& fonts, bool byName) {
+	VyFontCache* cache = engine.GetFontCache();
+	cache->ResetStats();
+	BenchSamples switches;
+	switches.Reserve(count);
+	for (int i = 0; i < count; ++i) {
+		VyEngine::FontId font = fonts[i % fonts.size()];
+		BenchTimePoint t0 = BenchClock::now();
+		if (byName) {
+			engine.SetFont(BenchFontName, cache->GetSize(font));
+		} else {
+			engine.SetFont(font);
+		}
+		switches.Add(t0, BenchClock::now());
+	}
+	switches.PrintRow(scene, count, "SetFont");
+	const VyFontCache::Stats& stats = cache->GetStats();
+	fprintf(stderr, "%s %d: %d hits, %d misses, %d evictions, %d file reads, %zu bytes\n", scene, count,
+		stats.hits, stats.misses, stats.evictions, stats.fileReads, cache->GetUsedBytes());
+}
+
+void RunFontBenchmark(int count, const BenchSettings& settings) {
+	VyEngine& engine = *VyEngine::GetInstance();
+	VyFontCache* cache = engine.GetFontCache();
+	VyEngine::FontId previous = engine.GetFontId();
+	size_t budget = cache->GetBudget();
+	std::vector<VyEngine::FontId> fonts;
+	int sizeCount = std::min(count, 48);
+	for (int i = 0; i < sizeCount; ++i) {
+		fonts.push_back(engine.RegisterFont(BenchFontName, 8 + i));
+	}
+	if (engine.SetFont(fonts[0]) != VyEngine::ErrorCode::Success) {
+		fprintf(stderr, "skipping fonts: %s", engine.ErrorMessage.c_str());
+		engine.ErrorMessage = "";
+		return;
+	}
+	RunSwitches(engine, "fonts-name", count, fonts, true);
+	RunSwitches(engine, "fonts-id", count, fonts, false);
+	// room for the file and only a few sizes
+	cache->SetBudget(cache->GetUsedBytes() / 4);
+	RunSwitches(engine, "fonts-evicting", count, fonts, false);
+	cache->SetBudget(budget);
+	engine.SetFont(previous);
+	fflush(stdout);
+}
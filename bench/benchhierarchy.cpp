@@ -0,0 +1,68 @@
+#include <SDL.h>
+#include <memory>
+#include <vector>
+#include "rect.h"
+#include "vyobjectcommonbase.h"
+#include "vyhierarchied.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+/// <summary>
+/// the cheapest rect component: a rect the hierarchy can move, and an update that touches only itself
+/// </summary>
+class BenchRect : public VyObjectCommonBase, public VyUpdatable, public HasRect {
+public:
+	Rect rect;
+	int updates;
+	BenchRect(Rect rect) : VyObjectCommonBase("rect"), rect(rect), updates(0) {}
+	virtual VyUpdatable* AsUpdatable() { return this; }
+	virtual HasRect* AsRect() { return this; }
+	virtual Rect* GetRect() { return &rect; }
+	virtual void Update() { ++updates; }
+};
+
+void RunHierarchyBenchmark(int count, const BenchSettings& settings) {
+	// the old way: every rect placed in the world by hand, each one edited to move the panel
+	std::vector<std::shared_ptr<BenchRect>> loose(count);
+	for (int i = 0; i < count; ++i) {
+		loose[i] = std::make_shared<BenchRect>(Rect(i % 40 * 20, i / 40 * 20, 16, 16));
+	}
+	// a scene with a panel, count children under it, each with one rect component relative to its node
+	std::shared_ptr<VyHierarched> scene = std::make_shared<VyHierarched>("scene");
+	std::shared_ptr<VyHierarched> panel = std::make_shared<VyHierarched>("panel");
+	scene->AddChild(panel);
+	for (int i = 0; i < count; ++i) {
+		std::shared_ptr<VyHierarched> child = std::make_shared<VyHierarched>("child");
+		child->SetLocalPosition(Coord(i % 40 * 20, i / 40 * 20));
+		child->AddComponent<BenchRect>(Rect(0, 0, 16, 16));
+		panel->AddChild(child);
+	}
+	scene->UpdateTransforms();
+
+	BenchSamples manual, moved, still, update;
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		Coord offset(f % 100, f % 50);
+		BenchTimePoint t0 = BenchClock::now();
+		for (int i = 0; i < count; ++i) {
+			loose[i]->rect.SetPosition(offset + Coord(i % 40 * 20, i / 40 * 20));
+		}
+		BenchTimePoint t1 = BenchClock::now();
+		panel->SetLocalPosition(offset);
+		scene->UpdateTransforms();
+		BenchTimePoint t2 = BenchClock::now();
+		scene->UpdateTransforms();
+		BenchTimePoint t3 = BenchClock::now();
+		scene->Update();
+		BenchTimePoint t4 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		manual.Add(t0, t1);
+		moved.Add(t1, t2);
+		still.Add(t2, t3);
+		update.Add(t3, t4);
+	}
+	manual.PrintRow("hierarchy-manual", count, "MovePanel");
+	moved.PrintRow("hierarchy-graph", count, "MovePanel");
+	still.PrintRow("hierarchy-graph", count, "Unmoved");
+	update.PrintRow("hierarchy-graph", count, "Update");
+	fflush(stdout);
+}
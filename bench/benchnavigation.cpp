@@ -0,0 +1,100 @@
+#include <SDL.h>
+#include <math.h>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "selectablerect.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+// the all-pairs search SelectableRect::SetupNavigation used before VyNavigationGraph, kept here as the baseline
+static int LegacyBestCandidate(const std::vector<SelectableRect*>& rects, const std::vector<Coord>& centers, int selfId, std::function<bool(Coord delta)> vetting) {
+	Coord selfCenter = centers[selfId];
+	int bestCandidate = -1;
+	float bestCandidateDistance = 0;
+	for (int candidateId = 0; candidateId < centers.size(); ++candidateId) {
+		if (selfId == candidateId || !rects[candidateId]->IsNavigatable()) {
+			continue;
+		}
+		Coord delta = centers[candidateId] - selfCenter;
+		if (vetting(delta)) {
+			float distance = delta.MagnitudeSq();
+			if (bestCandidateDistance == 0 || distance < bestCandidateDistance) {
+				bestCandidateDistance = distance;
+				bestCandidate = candidateId;
+			}
+		}
+	}
+	return bestCandidate;
+}
+
+static void LegacySetupNavigation(const std::vector<SelectableRect*>& rects) {
+	std::vector<Coord> centers;
+	centers.reserve(rects.size());
+	for (int i = 0; i < rects.size(); ++i) {
+		rects[i]->ClearNavigation();
+		centers.push_back(rects[i]->GetCenter());
+	}
+	std::function<bool(Coord delta)> vetting[(int)Rect::Dir::Count] = {
+		[](Coord delta) -> bool { return delta.y < 0 && abs(delta.x) <= abs(delta.y); },
+		[](Coord delta) -> bool { return delta.x < 0 && abs(delta.x) >= abs(delta.y); },
+		[](Coord delta) -> bool { return delta.y > 0 && abs(delta.x) <= abs(delta.y); },
+		[](Coord delta) -> bool { return delta.x > 0 && abs(delta.x) >= abs(delta.y); },
+	};
+	for (int dir = 0; dir < (int)Rect::Dir::Count; ++dir) {
+		for (int selfId = 0; selfId < centers.size(); ++selfId) {
+			int best = LegacyBestCandidate(rects, centers, selfId, vetting[dir]);
+			if (best >= 0) {
+				rects[selfId]->SetNavigation((Rect::Dir)dir, rects[best]);
+			}
+		}
+	}
+}
+
+/// <summary>
+/// a square-ish grid menu of rects, 40x30 apart
+/// </summary>
+static void BuildMenu(std::vector<std::unique_ptr<SelectableRect>>& owned, std::vector<SelectableRect*>& rects, int count) {
+	int columns = (int)ceil(sqrt((double)count));
+	for (int i = 0; i < count; ++i) {
+		SelectableRect* rect = new SelectableRect({ (i % columns) * 40, (i / columns) * 30, 30, 20 });
+		owned.push_back(std::unique_ptr<SelectableRect>(rect));
+		rects.push_back(rect);
+	}
+}
+
+void RunNavigationBenchmark(int count, const BenchSettings& settings) {
+	std::vector<std::unique_ptr<SelectableRect>> owned;
+	std::vector<SelectableRect*> rects;
+	BuildMenu(owned, rects, count);
+
+	BenchSamples legacyBuild, graphBuild, move, toggle;
+	BenchTimePoint t0 = BenchClock::now();
+	LegacySetupNavigation(rects);
+	legacyBuild.Add(t0, BenchClock::now());
+
+	VyNavigationGraph graph;
+	t0 = BenchClock::now();
+	graph.Build(rects);
+	graphBuild.Add(t0, BenchClock::now());
+
+	// one rect per frame wanders around the menu, another flips navigatable
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		SelectableRect* moving = rects[(f * 7) % count];
+		SelectableRect* toggled = rects[(f * 13) % count];
+		Coord target((f * 37) % (int)(sqrt((double)count) * 40 + 1), (f * 23) % (int)(sqrt((double)count) * 30 + 1));
+		BenchTimePoint t1 = BenchClock::now();
+		moving->MoveTo(target);
+		BenchTimePoint t2 = BenchClock::now();
+		toggled->SetNavigatable(!toggled->IsNavigatable());
+		BenchTimePoint t3 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		move.Add(t1, t2);
+		toggle.Add(t2, t3);
+	}
+	legacyBuild.PrintRow("navigation-legacy", count, "Build");
+	graphBuild.PrintRow("navigation-graph", count, "Build");
+	move.PrintRow("navigation-graph", count, "MoveOne");
+	toggle.PrintRow("navigation-graph", count, "ToggleOne");
+	fflush(stdout);
+}
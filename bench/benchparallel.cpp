@@ -0,0 +1,146 @@
+#include <SDL.h>
+#include <math.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "vyengine.h"
+#include "vyjobsystem.h"
+#include "vyactionqueue.h"
+#include "stringstuff.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+
+/// <summary>
+/// a few microseconds of floating point work on its own state per update, like a physics or AI step
+/// </summary>
+class BenchSimulated : public VyUpdatable {
+public:
+	float x, y, vx, vy;
+	int id;
+	BenchSimulated(int id) : x((float)(id % 97)), y((float)(id % 89)), vx(1), vy(0), id(id) {}
+	virtual bool IsParallelSafe() const { return true; }
+	virtual void Update() {
+		for (int i = 0; i < 64; ++i) {
+			// orbit the origin, with a little drag
+			float distance = sqrtf(x * x + y * y) + 1;
+			vx -= x / (distance * distance * distance) * 0.1f;
+			vy -= y / (distance * distance * distance) * 0.1f;
+			vx *= 0.999f;
+			vy *= 0.999f;
+			x += vx * 0.01f;
+			y += vy * 0.01f;
+		}
+		if (id % 1000 == 0) {
+			// the rare change to shared state, deferred to ServiceQueue
+			VyEngine::GetInstance()->Queue([]() {}, VY_HERE);
+		}
+	}
+};
+
+void RunParallelBenchmark(int count, const BenchSettings& settings) {
+	VyEngine* engine = VyEngine::GetInstance();
+	std::vector<std::unique_ptr<BenchSimulated>> simulated;
+	for (int i = 0; i < count; ++i) {
+		simulated.push_back(std::unique_ptr<BenchSimulated>(new BenchSimulated(i)));
+		engine->RegisterUpdatable(simulated.back().get());
+	}
+	bool wasParallel = engine->UseParallelUpdate;
+	// 0 is the serial loop, without the job system at all
+	std::vector<int> threadCounts = { 0 };
+	int cores = SDL_GetCPUCount();
+	for (int threads = 1; threads < cores; threads *= 2) {
+		threadCounts.push_back(threads);
+	}
+	threadCounts.push_back(cores);
+	for (int t = 0; t < threadCounts.size(); ++t) {
+		int threads = threadCounts[t];
+		engine->UseParallelUpdate = threads > 0;
+		if (threads > 0) {
+			engine->GetJobSystem()->SetThreadCount(threads);
+		}
+		BenchSamples update;
+		for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+			BenchTimePoint t0 = BenchClock::now();
+			engine->Update();
+			BenchTimePoint t1 = BenchClock::now();
+			if (f < settings.warmup) { continue; }
+			update.Add(t0, t1);
+		}
+		std::string scene = threads == 0 ? "parallel-serial" : string_format("parallel-%dt", threads);
+		update.PrintRow(scene.c_str(), count, "Update");
+		fflush(stdout);
+	}
+	engine->UseParallelUpdate = wasParallel;
+	for (int i = 0; i < count; ++i) {
+		engine->UnregisterUpdatable(simulated[i].get());
+	}
+}
+
+/// <summary>
+/// the deferred queue VyEngine::Queue used before VyActionQueue, made thread-safe with a mutex, kept here as the baseline
+/// </summary>
+class LegacyDeferredQueue {
+public:
+	struct Deferred {
+		std::string src;
+		std::function<void()> action;
+	};
+	std::mutex mutex;
+	std::vector<Deferred> todo, todoNow;
+	void Queue(std::function<void()> action, std::string src) {
+		std::lock_guard<std::mutex> lock(mutex);
+		todo.push_back({ src, action });
+	}
+	void Service() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			todo.swap(todoNow);
+		}
+		for (int i = 0; i < todoNow.size(); ++i) {
+			todoNow[i].action();
+		}
+		todoNow.clear();
+	}
+};
+
+void RunDeferredBenchmark(int count, const BenchSettings& settings) {
+	VyJobSystem jobs;
+	VyActionQueue actions(4096);
+	LegacyDeferredQueue legacy;
+	std::vector<int> targets(count, 0);
+	BenchSamples legacyPost, legacyService, post, service;
+	for (int f = 0; f < settings.warmup + settings.frames; ++f) {
+		// every index posts one action from whichever worker it lands on, like parallel updatables deferring a change
+		BenchTimePoint t0 = BenchClock::now();
+		jobs.ParallelFor(count, 64, [&legacy, &targets](int begin, int end) {
+			for (int i = begin; i < end; ++i) {
+				int* target = &targets[i];
+				legacy.Queue([target]() { ++*target; }, string_format(__FILE__ ":%d", __LINE__));
+			}
+		});
+		BenchTimePoint t1 = BenchClock::now();
+		legacy.Service();
+		BenchTimePoint t2 = BenchClock::now();
+		jobs.ParallelFor(count, 64, [&actions, &targets](int begin, int end) {
+			for (int i = begin; i < end; ++i) {
+				int* target = &targets[i];
+				actions.Post([target]() { ++*target; }, VY_HERE);
+			}
+		});
+		BenchTimePoint t3 = BenchClock::now();
+		actions.Service(VyActionQueue::Phase::Update);
+		BenchTimePoint t4 = BenchClock::now();
+		if (f < settings.warmup) { continue; }
+		legacyPost.Add(t0, t1);
+		legacyService.Add(t1, t2);
+		post.Add(t2, t3);
+		service.Add(t3, t4);
+	}
+	legacyPost.PrintRow("deferred-legacy", count, "Queue");
+	legacyService.PrintRow("deferred-legacy", count, "Service");
+	post.PrintRow("deferred-mpsc", count, "Queue");
+	service.PrintRow("deferred-mpsc", count, "Service");
+	fflush(stdout);
+}
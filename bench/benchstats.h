@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+typedef BenchClock::time_point BenchTimePoint;
+
+/// <summary>
+/// collects per-frame durations (in microseconds) and reports min/median/p99
+/// </summary>
+class BenchSamples {
+private:
+	std::vector<double> _samples;
+	bool _sorted;
+public:
+	BenchSamples() : _sorted(true) {}
+
+	void Reserve(int count) { _samples.reserve(count); }
+	void Clear() { _samples.clear(); _sorted = true; }
+	int Count() const { return (int)_samples.size(); }
+
+	void Add(double microseconds) {
+		_samples.push_back(microseconds);
+		_sorted = false;
+	}
+
+	void Add(BenchTimePoint start, BenchTimePoint end) {
+		Add(std::chrono::duration<double, std::micro>(end - start).count());
+	}
+
+	/// <param name="percent">0 to 100</param>
+	double Percentile(double percent) {
+		if (_samples.empty()) { return 0; }
+		Sort();
+		int index = (int)((percent / 100) * _samples.size() + 0.5) - 1;
+		index = std::max(0, std::min(index, (int)_samples.size() - 1));
+		return _samples[index];
+	}
+
+	double Min() { return Percentile(0); }
+	double Median() { Sort(); return _samples.empty() ? 0 : _samples[_samples.size() / 2]; }
+	double Max() { return Percentile(100); }
+
+	double Mean() const {
+		if (_samples.empty()) { return 0; }
+		double sum = 0;
+		for (double s : _samples) { sum += s; }
+		return sum / _samples.size();
+	}
+
+	double Total() const {
+		double sum = 0;
+		for (double s : _samples) { sum += s; }
+		return sum;
+	}
+
+	static void PrintHeader() {
+		printf("scene,count,phase,frames,min_us,median_us,p99_us,mean_us\n");
+	}
+
+	/// <summary>
+	/// one machine-readable CSV row, matching <see cref="BenchSamples::PrintHeader"/>
+	/// </summary>
+	void PrintRow(const char* scene, int count, const char* phase) {
+		printf("%s,%d,%s,%d,%.2f,%.2f,%.2f,%.2f\n", scene, count, phase, Count(), Min(), Median(), Percentile(99), Mean());
+	}
+private:
+	void Sort() {
+		if (_sorted) { return; }
+		std::sort(_samples.begin(), _samples.end());
+		_sorted = true;
+	}
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+
+class BenchSettings {
+public:
+	std::string scene;
+	int count;
+	int frames;
+	int warmup;
+	std::string tracePath;
+	/// <summary>"renderer", "surface" / "damage" for Renderer::SDL_Surface without / with damage tracking, or "offscreen" for Renderer::Offscreen</summary>
+	std::string renderer;
+	/// <summary>scripted scenes write the input they push to this file, see <see cref="VyEngine::StartRecording"/></summary>
+	std::string recordPath;
+	/// <summary>scripted scenes take their input from this recording instead of the script, for as many frames as it has</summary>
+	std::string replayPath;
+	BenchSettings() : scene("all"), count(-1), frames(600), warmup(60), tracePath(), renderer("renderer"), recordPath(), replayPath() {}
+};
+
+/// <summary>
+/// key/mouse delegate dispatch: the original nested std::map of std::function against VyDelegateTable
+/// </summary>
+void RunDispatchBenchmark(int owners, const BenchSettings& settings);
+
+/// <summary>
+/// SelectableRect navigation: the original all-pairs setup against VyNavigationGraph, plus its incremental updates
+/// </summary>
+void RunNavigationBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// loading count copies of an image: synchronously in one frame, against async decode with per-frame upload budget
+/// </summary>
+void RunAssetBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// switching between count font sizes by name and by id, then with a memory budget too small to keep them all open
+/// </summary>
+void RunFontBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// updating count moving components: virtual calls through VyComponentContainer against a VyComponentStore, per entity and in batches
+/// </summary>
+void RunComponentBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// spawning and dropping count game objects with two components per frame: shared_ptr(new) against the object pools
+/// </summary>
+void RunSpawnBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// count CPU-heavy parallel-safe updatables through VyEngine::Update: serially, then with the job system on 1, 2, 4... up to every core
+/// </summary>
+void RunParallelBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// count actions deferred per frame from the job system's threads: the old mutex and std::function queue against VyActionQueue
+/// </summary>
+void RunDeferredBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// moving a panel with count children: every rect edited by hand against one dirty mark on a VyHierarched, then the flattened traversal
+/// </summary>
+void RunHierarchyBenchmark(int count, const BenchSettings& settings);
+
+/// <summary>
+/// a burst of mouse motion and a key press per frame with count key-only processors: every event to every processor against masks and coalescing
+/// </summary>
+void RunEventBenchmark(int count, const BenchSettings& settings);
@@ -0,0 +1,490 @@
+#include "vyengine.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include "button.h"
+#include "sdltext.h"
+#include "benchstats.h"
+#include "benchsuites.h"
+#include "vyprofiler.h"
+#include "vyatlas.h"
+#include "vyspritebatch.h"
+#include "vyrenderqueue.h"
+#include "vyprimitivebatch.h"
+#include "vycirclecache.h"
+
+// Headless frame-loop benchmark. Runs VyEngine under SDL's dummy video driver with the software renderer,
+// drives scripted scenes, and prints per-phase frame times as CSV (see BenchSamples::PrintHeader).
+// usage: hellosdl_bench [--scene buttons|texts|circles|circles-batch|circles-sprite|sprites|labels|mixed|dispatch|navigation|assets|fonts|queue|components|spawn|parallel|deferred|hierarchy|scrolling|events|all] [--count N] [--frames F] [--warmup W] [--trace file.json] [--renderer renderer|surface|damage|offscreen] [--record file.vyin | --replay file.vyin]
+// --trace only produces output when built with VY_PROFILE
+// --renderer surface|damage draw into the window surface, without or with damage tracking. only buttons, texts, circles, circles-batch, mixed and scrolling run there
+// --renderer offscreen draws into a memory surface without a window, as on a server
+// --record writes the scripted input of a scene to a file, --replay drives the scene from one at full speed instead, until it runs out. use with a single --scene and --count
+
+const int SCREEN_WIDTH = 640;
+const int SCREEN_HEIGHT = 480;
+
+/// <summary>
+/// a filled circle with an outline, drawn right away, added to the engine's primitive batch with every other circle,
+/// or drawn as two cached circle sprites through the sprite batch
+/// </summary>
+class BenchCircle : public VyDrawable {
+public:
+	enum class Mode { Direct, Batch, Sprite };
+	Coord center;
+	int radius;
+	long color;
+	Mode mode;
+	BenchCircle(Coord center, int radius, long color, Mode mode) : center(center), radius(radius), color(color), mode(mode) {
+		VyEngine::GetInstance()->RegisterDrawable(this);
+	}
+	~BenchCircle() {
+		VyEngine::GetInstance()->UnregisterDrawable(this);
+	}
+	virtual bool GetDrawBounds(SDL_Rect& out_bounds) {
+		// the outline is the outermost part
+		int extent = radius + 3;
+		out_bounds = { center.x - extent, center.y - extent, extent * 2, extent * 2 };
+		return true;
+	}
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) {
+		switch (mode) {
+		case Mode::Batch: {
+			VyPrimitiveBatch& batch = *VyEngine::GetInstance()->GetPrimitiveBatch();
+			batch.SetColor(color);
+			VyFillCircle(batch, (float)center.x, (float)center.y, (float)radius);
+			VyDrawCircle(batch, (float)center.x, (float)center.y, (float)radius + 2);
+			return;
+		}
+		case Mode::Sprite: {
+			VyEngine* engine = VyEngine::GetInstance();
+			VyCircleCache* cache = engine->GetCircleCache();
+			if (cache == NULL) { return; }
+			SDL_Color tint = VyRenderQueue::ToColor(color);
+			cache->Draw(*engine->GetSpriteBatch(), (float)center.x, (float)center.y, (float)radius, true, tint);
+			cache->Draw(*engine->GetSpriteBatch(), (float)center.x, (float)center.y, (float)radius + 2, false, tint);
+			return;
+		}
+		default: {
+			Coord at = center + offset;
+			SDL_SetRenderDrawColor(g, color);
+			SDL_FillCircle(g, (float)at.x, (float)at.y, (float)radius);
+			SDL_DrawCircle(g, (float)at.x, (float)at.y, (float)radius + 2);
+		}
+		}
+	}
+};
+
+/// <summary>
+/// a small image drawn either from its own texture with SDL_RenderCopy, or from the atlas through the shared sprite batch
+/// </summary>
+class BenchSprite : public VyDrawable {
+public:
+	SDL_Texture* texture;
+	const VyAtlasSprite* sprite;
+	Rect dest;
+	BenchSprite(SDL_Texture* texture, const VyAtlasSprite* sprite, Rect dest) : texture(texture), sprite(sprite), dest(dest) {
+		VyEngine::GetInstance()->RegisterDrawable(this);
+	}
+	~BenchSprite() {
+		VyEngine::GetInstance()->UnregisterDrawable(this);
+	}
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) {
+		if (sprite != NULL) {
+			VyEngine::GetInstance()->GetSpriteBatch()->Draw(*sprite, dest);
+		} else {
+			SDL_Rect area = { dest.x + offset.x, dest.y + offset.y, dest.w, dest.h };
+			SDL_RenderCopy(g, texture, NULL, &area);
+		}
+	}
+};
+
+class BenchScene {
+public:
+	std::vector<std::unique_ptr<Button>> buttons;
+	std::vector<std::unique_ptr<SdlText>> texts;
+	std::vector<std::unique_ptr<BenchCircle>> circles;
+	std::vector<std::unique_ptr<BenchSprite>> sprites;
+	std::vector<SDL_Texture*> spriteTextures;
+	std::vector<VyAtlasSprite> atlasSprites;
+	std::vector<SelectableRect*> navigation;
+	int changingText;
+	/// <summary>every text changes every frame, instead of just changingText</summary>
+	bool changingAllTexts;
+	/// <summary>the camera pans across a world ScrollingScreens wide, one screen of it visible at a time</summary>
+	bool scrolling;
+	BenchScene() : changingText(-1), changingAllTexts(false), scrolling(false) {}
+	~BenchScene() {
+		sprites.clear();
+		for (int i = 0; i < spriteTextures.size(); ++i) {
+			VyEngine::GetInstance()->ReleaseSdlTexture(spriteTextures[i]);
+		}
+	}
+};
+
+static Coord GridPosition(int index, Coord cellSize, int screensWide = 1) {
+	int columns = SCREEN_WIDTH * screensWide / cellSize.x;
+	int rows = SCREEN_HEIGHT / cellSize.y;
+	int perScreen = columns * rows;
+	index = index % perScreen;
+	return Coord((index % columns) * cellSize.x, (index / columns) * cellSize.y);
+}
+
+/// <summary>
+/// how many screens wide the scrolling scene's world is
+/// </summary>
+const int ScrollingScreens = 10;
+
+/// <summary>
+/// 16 distinct 16x16 images, loaded as separate textures and into the atlas
+/// </summary>
+static void LoadSpriteImages(BenchScene& scene) {
+	VyEngine* engine = VyEngine::GetInstance();
+	const int imageCount = 16;
+	scene.atlasSprites.resize(imageCount);
+	for (int i = 0; i < imageCount; ++i) {
+		SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 16, 16, 32, SDL_PIXELFORMAT_ARGB8888);
+		SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, (Uint8)(i * 16), (Uint8)(255 - i * 16), 0x80, 0xFF));
+		SDL_Rect inner = { 4, 4, 8, 8 };
+		SDL_FillRect(surface, &inner, SDL_MapRGBA(surface->format, 0xFF, 0xFF, 0xFF, 0x80));
+		SDL_Texture* texture = NULL;
+		engine->LoadSdlTexture(surface, texture);
+		scene.spriteTextures.push_back(texture);
+		engine->LoadAtlasSprite(surface, scene.atlasSprites[i]);
+		SDL_FreeSurface(surface);
+	}
+}
+
+static void BuildScene(BenchScene& scene, const std::string& kind, int count) {
+	bool mixed = kind == "mixed";
+	int buttonCount = kind == "buttons" ? count : mixed ? count / 3 : 0;
+	int textCount = kind == "texts" ? count : mixed ? count / 3 : 0;
+	BenchCircle::Mode circleMode = kind == "circles-batch" ? BenchCircle::Mode::Batch : kind == "circles-sprite" ? BenchCircle::Mode::Sprite : BenchCircle::Mode::Direct;
+	int circleCount = kind == "circles" || circleMode != BenchCircle::Mode::Direct ? count : mixed ? count - buttonCount - textCount : 0;
+	for (int i = 0; i < buttonCount; ++i) {
+		Coord p = GridPosition(i, Coord(32, 24));
+		Button* button = new Button({ p.x, p.y, 30, 20 });
+		scene.buttons.push_back(std::unique_ptr<Button>(button));
+		scene.navigation.push_back(button);
+	}
+	bool labelsTexture = kind == "labels-texture", labelsGlyph = kind == "labels-glyph";
+	if (labelsTexture || labelsGlyph) {
+		textCount = count;
+		scene.changingAllTexts = true;
+	}
+	for (int i = 0; i < textCount; ++i) {
+		Coord p = GridPosition(i, Coord(80, 20));
+		SdlText* text = new SdlText(string_format("label %d", i));
+		text->DestRect().SetPosition(p);
+		text->SetGlyphMode(labelsGlyph);
+		scene.texts.push_back(std::unique_ptr<SdlText>(text));
+	}
+	if (textCount > 0) {
+		scene.changingText = 0;
+	}
+	bool spritesCopy = kind == "sprites-copy", spritesAtlas = kind == "sprites-atlas";
+	if (spritesCopy || spritesAtlas) {
+		LoadSpriteImages(scene);
+		for (int i = 0; i < count; ++i) {
+			Coord p = GridPosition(i, Coord(20, 20));
+			int image = i % (int)scene.spriteTextures.size();
+			const VyAtlasSprite* sprite = spritesAtlas ? &scene.atlasSprites[image] : NULL;
+			scene.sprites.push_back(std::unique_ptr<BenchSprite>(new BenchSprite(scene.spriteTextures[image], sprite, Rect(p.x, p.y, 16, 16))));
+		}
+	}
+	for (int i = 0; i < circleCount; ++i) {
+		Coord p = GridPosition(i, Coord(40, 40)) + Coord(20, 20);
+		scene.circles.push_back(std::unique_ptr<BenchCircle>(new BenchCircle(p, 16, 0x8800ff00, circleMode)));
+	}
+	if (kind == "scrolling") {
+		scene.scrolling = true;
+		for (int i = 0; i < count; ++i) {
+			Coord p = GridPosition(i, Coord(40, 40), ScrollingScreens) + Coord(20, 20);
+			scene.circles.push_back(std::unique_ptr<BenchCircle>(new BenchCircle(p, 16, 0x8800ff00, BenchCircle::Mode::Direct)));
+		}
+	}
+}
+
+static void PushMouseButton(Coord position, bool pressed) {
+	SDL_Event e = {};
+	e.type = pressed ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+	e.button.button = SDL_BUTTON_LEFT;
+	e.button.state = pressed ? SDL_PRESSED : SDL_RELEASED;
+	e.button.x = position.x;
+	e.button.y = position.y;
+	SDL_PushEvent(&e);
+}
+
+static void PushKey(SDL_Keycode key, bool pressed) {
+	SDL_Event e = {};
+	e.type = pressed ? SDL_KEYDOWN : SDL_KEYUP;
+	e.key.state = pressed ? SDL_PRESSED : SDL_RELEASED;
+	e.key.keysym.sym = key;
+	e.key.keysym.scancode = SDL_GetScancodeFromKey(key);
+	SDL_PushEvent(&e);
+}
+
+/// <summary>
+/// deterministic input for one frame: sweep the mouse across the screen, click periodically, navigate with arrows
+/// </summary>
+static void ScriptInput(int frame) {
+	Coord mouse((frame * 7) % SCREEN_WIDTH, (frame * 3) % SCREEN_HEIGHT);
+	SDL_Event motion = {};
+	motion.type = SDL_MOUSEMOTION;
+	motion.motion.x = mouse.x;
+	motion.motion.y = mouse.y;
+	motion.motion.xrel = 7;
+	motion.motion.yrel = 3;
+	SDL_PushEvent(&motion);
+	switch (frame % 10) {
+	case 0: PushMouseButton(mouse, true); break;
+	case 1: PushMouseButton(mouse, false); break;
+	case 5: PushKey(SDLK_RIGHT, true); break;
+	case 6: PushKey(SDLK_RIGHT, false); break;
+	}
+}
+
+static void ScriptUpdate(BenchScene& scene, int frame) {
+	if (scene.scrolling) {
+		VyEngine::GetInstance()->GetCamera()->SetPosition(Coord((frame * 8) % (SCREEN_WIDTH * (ScrollingScreens - 1)), 0));
+	}
+	if (scene.changingAllTexts) {
+		for (int i = 0; i < scene.texts.size(); ++i) {
+			scene.texts[i]->SetText(string_format("%d: %d", i, frame), "", -1);
+		}
+		return;
+	}
+	if (scene.changingText < 0) { return; }
+	scene.texts[scene.changingText]->SetText(string_format("frame %d", frame), "", -1);
+}
+
+static bool HasSuffix(const std::string& kind, const std::string& suffix) {
+	return kind.size() > suffix.size() && kind.compare(kind.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/// <summary>
+/// a kind ending in "-queue" builds the same scene without the suffix, and renders it through the engine's render queue.
+/// one ending in "-nocull" renders it without culling.
+/// with settings.replayPath, input comes from the recording, and the scene runs for as many frames as it has instead of warmup + frames
+/// </summary>
+static void RunScene(VyEngine& engine, const std::string& kind, int count, const BenchSettings& settings) {
+	BenchSamples setup, script, input, update, queue, render, frame, readback;
+	BenchTimePoint start = BenchClock::now();
+	const std::string queueSuffix = "-queue", noCullSuffix = "-nocull";
+	bool queued = HasSuffix(kind, queueSuffix);
+	bool noCull = HasSuffix(kind, noCullSuffix);
+	engine.UseRenderQueue = queued;
+	engine.UseCulling = !noCull;
+	BenchScene scene;
+	BuildScene(scene, queued ? kind.substr(0, kind.size() - queueSuffix.size()) : noCull ? kind.substr(0, kind.size() - noCullSuffix.size()) : kind, count);
+	SelectableRect::SetupNavigation(scene.navigation);
+	if (!scene.buttons.empty()) {
+		scene.buttons[0]->SetSelected(true);
+	}
+	setup.Add(start, BenchClock::now());
+	script.Reserve(settings.frames);
+	input.Reserve(settings.frames);
+	update.Reserve(settings.frames);
+	queue.Reserve(settings.frames);
+	render.Reserve(settings.frames);
+	readback.Reserve(settings.frames);
+	frame.Reserve(settings.frames);
+	// a server renders to read the frame back, so that's part of its frame
+	bool offscreen = settings.renderer == "offscreen";
+	bool replaying = settings.replayPath != "";
+	if (replaying && engine.StartReplay(settings.replayPath) != VyEngine::ErrorCode::Success) {
+		fprintf(stderr, "%s\n", engine.ErrorMessage.c_str());
+		return;
+	}
+	if (settings.recordPath != "") {
+		engine.StartRecording(settings.recordPath);
+		engine.FailFast();
+	}
+	int drawCalls = 0, culled = 0, measured = 0, played = 0;
+	BenchTimePoint loopStart = BenchClock::now();
+	for (int f = 0; replaying || f < settings.warmup + settings.frames; ++f) {
+		if (!replaying) {
+			ScriptInput(f);
+		}
+		BenchTimePoint t0 = BenchClock::now();
+		ScriptUpdate(scene, f);
+		BenchTimePoint t1 = BenchClock::now();
+		engine.ProcessInput();
+		if (replaying && !engine.IsReplaying()) { break; }
+		BenchTimePoint t2 = BenchClock::now();
+		// as many updates as the recorded frame ran, one when scripted
+		int steps = replaying ? engine.GetReplaySteps() : 1;
+		for (int step = 0; step < steps; ++step) {
+			engine.ProcessUpdatables();
+		}
+		BenchTimePoint t3 = BenchClock::now();
+		engine.ServiceQueue();
+		BenchTimePoint t4 = BenchClock::now();
+		engine.ClearGraphics();
+		engine.Render();
+		BenchTimePoint t5 = BenchClock::now();
+		if (offscreen) {
+			SDL_Surface* pixels = NULL;
+			engine.ReadPixels(pixels);
+			SDL_FreeSurface(pixels);
+		}
+		BenchTimePoint t6 = BenchClock::now();
+		engine.FailFast();
+		++played;
+		if (f < settings.warmup) { continue; }
+		++measured;
+		if (engine.GetRenderQueue() != NULL) {
+			drawCalls += engine.GetRenderQueue()->GetDrawCalls();
+		}
+		culled += engine.GetCamera()->GetCulledCount();
+		script.Add(t0, t1);
+		input.Add(t1, t2);
+		update.Add(t2, t3);
+		queue.Add(t3, t4);
+		render.Add(t4, t5);
+		readback.Add(t5, t6);
+		frame.Add(t0, t6);
+	}
+	double loopTime = std::chrono::duration<double>(BenchClock::now() - loopStart).count();
+	if (settings.recordPath != "") {
+		engine.StopRecording();
+		engine.FailFast();
+	}
+	const char* name = kind.c_str();
+	setup.PrintRow(name, count, "Setup");
+	script.PrintRow(name, count, "SetText");
+	input.PrintRow(name, count, "ProcessInput");
+	update.PrintRow(name, count, "Update");
+	queue.PrintRow(name, count, "ServiceQueue");
+	render.PrintRow(name, count, "Render");
+	if (offscreen) {
+		readback.PrintRow(name, count, "ReadPixels");
+	}
+	frame.PrintRow(name, count, "Frame");
+	if (queued) {
+		fprintf(stderr, "%s %d: %.1f draw calls per frame\n", name, count, (double)drawCalls / measured);
+	}
+	if (replaying) {
+		fprintf(stderr, "%s %d: replayed %d frames in %.3f s\n", name, count, played, loopTime);
+	}
+	if (scene.scrolling) {
+		fprintf(stderr, "%s %d: %.1f drawables culled per frame\n", name, count, (double)culled / measured);
+		engine.GetCamera()->SetPosition(Coord());
+	}
+	engine.UseRenderQueue = false;
+	engine.UseCulling = true;
+	fflush(stdout);
+}
+
+static bool ParseArgs(int argc, char* args[], BenchSettings& settings) {
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = args[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--scene" && hasValue) {
+			settings.scene = args[++i];
+		} else if (arg == "--count" && hasValue) {
+			settings.count = atoi(args[++i]);
+		} else if (arg == "--frames" && hasValue) {
+			settings.frames = atoi(args[++i]);
+		} else if (arg == "--warmup" && hasValue) {
+			settings.warmup = atoi(args[++i]);
+		} else if (arg == "--trace" && hasValue) {
+			settings.tracePath = args[++i];
+		} else if (arg == "--renderer" && hasValue) {
+			settings.renderer = args[++i];
+		} else if (arg == "--record" && hasValue) {
+			settings.recordPath = args[++i];
+		} else if (arg == "--replay" && hasValue) {
+			settings.replayPath = args[++i];
+		} else {
+			fprintf(stderr, "usage: %s [--scene buttons|texts|circles|circles-batch|circles-sprite|sprites|labels|mixed|dispatch|navigation|assets|fonts|queue|components|spawn|parallel|deferred|hierarchy|scrolling|events|all] [--count N] [--frames F] [--warmup W] [--trace file.json] [--renderer renderer|surface|damage|offscreen] [--record file.vyin | --replay file.vyin]\n", args[0]);
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* args[])
+{
+	BenchSettings settings;
+	if (!ParseArgs(argc, args, settings)) {
+		return (int)VyEngine::ErrorCode::InputError;
+	}
+	// headless: no real display, and the software renderer so results are comparable across machines
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+	SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+	VyEngine engine(SCREEN_WIDTH, SCREEN_HEIGHT);
+	engine.WindowFlags = SDL_WINDOW_HIDDEN;
+	engine.RendererFlags = SDL_RENDERER_SOFTWARE;
+	bool surface = settings.renderer == "surface" || settings.renderer == "damage";
+	engine.UseDamageTracking = settings.renderer == "damage";
+	VyEngine::Renderer kind = surface ? VyEngine::Renderer::SDL_Surface
+		: settings.renderer == "offscreen" ? VyEngine::Renderer::Offscreen
+		: VyEngine::Renderer::SDL_Renderer;
+	engine.Init("hellosdl_bench", kind);
+	engine.FailFast();
+	engine.SetFont("arial", 16);
+	engine.FailFast();
+
+	std::vector<std::string> scenes;
+	if (settings.scene == "all" && surface) {
+		// the rest need textures in the atlas or the render queue
+		scenes = { "buttons", "texts", "circles", "circles-batch", "mixed", "scrolling" };
+	} else if (settings.scene == "all") {
+		scenes = { "buttons", "texts", "circles", "circles-batch", "circles-sprite", "sprites", "labels", "mixed", "dispatch", "navigation", "assets", "fonts", "queue", "components", "spawn", "parallel", "deferred", "hierarchy", "scrolling", "events" };
+	} else {
+		scenes.push_back(settings.scene);
+	}
+	std::vector<int> counts;
+	if (settings.count > 0) {
+		counts.push_back(settings.count);
+	} else {
+		counts = { 10, 100, 1000 };
+	}
+	BenchSamples::PrintHeader();
+	for (int s = 0; s < scenes.size(); ++s) {
+		for (int c = 0; c < counts.size(); ++c) {
+			if (scenes[s] == "dispatch") {
+				RunDispatchBenchmark(counts[c] * 10, settings);
+			} else if (scenes[s] == "sprites") {
+				RunScene(engine, "sprites-copy", counts[c], settings);
+				RunScene(engine, "sprites-atlas", counts[c], settings);
+			} else if (scenes[s] == "labels") {
+				RunScene(engine, "labels-texture", counts[c], settings);
+				RunScene(engine, "labels-glyph", counts[c], settings);
+			} else if (scenes[s] == "assets") {
+				RunAssetBenchmark(counts[c], settings);
+			} else if (scenes[s] == "queue") {
+				RunScene(engine, "buttons-queue", counts[c], settings);
+				RunScene(engine, "mixed-queue", counts[c], settings);
+			} else if (scenes[s] == "fonts") {
+				RunFontBenchmark(counts[c], settings);
+			} else if (scenes[s] == "components") {
+				RunComponentBenchmark(counts[c] * 100, settings);
+			} else if (scenes[s] == "spawn") {
+				RunSpawnBenchmark(counts[c] * 10, settings);
+			} else if (scenes[s] == "parallel") {
+				RunParallelBenchmark(counts[c] * 10, settings);
+			} else if (scenes[s] == "deferred") {
+				RunDeferredBenchmark(counts[c] * 10, settings);
+			} else if (scenes[s] == "hierarchy") {
+				RunHierarchyBenchmark(counts[c] * 10, settings);
+			} else if (scenes[s] == "scrolling") {
+				RunScene(engine, "scrolling-nocull", counts[c] * 10, settings);
+				RunScene(engine, "scrolling", counts[c] * 10, settings);
+			} else if (scenes[s] == "events") {
+				RunEventBenchmark(counts[c] * 10, settings);
+			} else if (scenes[s] == "navigation") {
+				RunNavigationBenchmark(counts[c] * 10, settings);
+			} else {
+				RunScene(engine, scenes[s], counts[c], settings);
+			}
+		}
+	}
+	if (settings.tracePath != "" && !VY_PROFILE_DUMP(settings.tracePath)) {
+		fprintf(stderr, "no trace written to %s (build with VY_PROFILE)\n", settings.tracePath.c_str());
+	}
+	engine.Release();
+	return 0;
+}
@@ -4,26 +4,21 @@
 #else
 #include "vyengine.h"
 #include <stdio.h>
-#include <chrono>
 #include "button.h"
 #include "sdltext.h"
 #include "sdlgameobject.h"
+#include "vyprofiler.h"
 
 const int SCREEN_WIDTH = 640;
 const int SCREEN_HEIGHT = 480;
 
-typedef std::chrono::high_resolution_clock Clock;
-typedef Clock::time_point TimePoint;
-typedef std::chrono::duration<double> HiResDuration;
-
 // TODO use this!
 std::shared_ptr<SdlGameObject> CreateButton(std::string buttonName, std::string text, Rect size) {
-	std::shared_ptr<SdlGameObject> buttonObject(new SdlGameObject(buttonName));
-	std::shared_ptr<SdlText> textComponent(new SdlText(text));
-	std::shared_ptr<Button> buttonComponent(new Button(size));
-	textComponent.get()->DestRect().SetPosition(size.GetPosition());
-	buttonObject.get()->AddComponent(buttonComponent);
-	buttonObject.get()->AddComponent(textComponent);
+	std::shared_ptr<SdlGameObject> buttonObject = SdlGameObject::Spawn(buttonName);
+	buttonObject->SetLocalPosition(size.GetPosition());
+	// component rects are relative to the object, so the text follows the button wherever the object moves
+	buttonObject->AddComponent<Button>(Rect(Coord(), size.GetSize()));
+	buttonObject->AddComponent<SdlText>(text);
 	return buttonObject;
 }
 
@@ -34,12 +29,38 @@ int main( int argc, char* args[] )
 		quitEvent.type = SDL_QUIT;
 		sdl.ProcessEvent(quitEvent);
 	});
+#ifdef VY_PROFILE
+	sdl.RegisterKeyDown('p', (size_t)&sdl, [](SDL_Event e) {
+		VY_PROFILE_DUMP("hellosdl_trace.json");
+	});
+#endif
+	// r starts and stops recording input, which "hellosdl --replay hellosdl_input.vyin" plays back at full speed
+	sdl.RegisterKeyDown('r', (size_t)&sdl, [&sdl](SDL_Event e) {
+		VyEngine::ErrorCode err = VyEngine::ErrorCode::Success;
+		if (sdl.IsRecording()) {
+			err = sdl.StopRecording();
+			printf("stopped recording\n");
+		} else if (!sdl.IsReplaying()) {
+			err = sdl.StartRecording("hellosdl_input.vyin");
+			if (err == VyEngine::ErrorCode::Success) {
+				printf("recording to hellosdl_input.vyin\n");
+			}
+		}
+		// a recording that can't be written isn't worth quitting over: Run would stop on the error left set
+		if (err != VyEngine::ErrorCode::Success) {
+			printf("%s\n", sdl.ErrorMessage.c_str());
+			sdl.ErrorMessage = "";
+		}
+	});
 	VyEngine::ErrorCode err = sdl.Init("sdl", VyEngine::Renderer::SDL_Renderer);
 	sdl.FailFast();
-	SDL_Texture* tex;
+	if (argc > 2 && std::string(args[1]) == "--replay") {
+		sdl.StartReplay(args[2]);
+		sdl.FailFast();
+	}
 	SDL_Texture* word;
-	sdl.LoadSdlTexture("img/helloworld.png", tex);
-	sdl.FailFast();
+	// decoded on a worker, shows up once uploaded
+	VyAssetHandle image = sdl.LoadSdlTextureAsync("img/helloworld.png");
 	SDL_Renderer* g = sdl.GetRenderer();
 	Rect fillRect(SCREEN_WIDTH / 4, SCREEN_HEIGHT / 4, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2);
 	SDL_SetRenderDrawColor(g, 0xFF008800);
@@ -72,14 +93,17 @@ int main( int argc, char* args[] )
 
 	Rect wordArea(buttons[0].GetPosition(), sdl.GetTextureSize(word));
 
-	SelectableRect::SetupNavigation(buttonRefs);
+	VyNavigationGraph navigation;
+	navigation.Build(buttonRefs);
 
 	SdlText textTest("testing");
 
-	while (sdl.IsRunning()) {
-		TimePoint t0 = Clock::now();
-		sdl.ClearGraphics();
-		SDL_RenderCopy(g, tex, NULL, NULL);
+	sdl.Run([&]() {
+		if (image.IsReady()) {
+			SDL_RenderCopy(g, image.GetTexture(), NULL, NULL);
+		} else if (image.IsFailed()) {
+			sdl.ErrorMessage = image.GetError();
+		}
 		long color = fillRect.IsContains(sdl.MousePosition) ? 0x880000FF : 0xFF0000FF;
 		SDL_SetRenderDrawColor(g, color);
 		SDL_RenderFillRect(g, &fillRect);
@@ -89,18 +113,15 @@ int main( int argc, char* args[] )
 		SDL_FillCircle(g, 200, 50, 50);
 		SDL_DrawCircle(g, 200, 50, 52);
 		SDL_RenderCopy(g, word, NULL, &wordArea);
-		sdl.Render();
-		sdl.FailFast();
-		sdl.ProcessInput();
-		sdl.FailFast();
-		sdl.Update();
-		sdl.FailFast();
-		TimePoint t1 = Clock::now();
-		HiResDuration time_span = std::chrono::duration_cast<HiResDuration>(t1 - t0);
-		double secondsDuration = time_span.count();
-		int maxFps = (int)(1 / secondsDuration);
-		printf("%d fps   \r", maxFps);
-		SDL_Delay(10);
+		double workTime = sdl.GetFrameWorkTime();
+		if (workTime > 0) {
+			printf("%d fps   \r", (int)(1 / workTime));
+		}
+	});
+	sdl.FailFast();
+	// write errors gathered while recording only show up here
+	if (sdl.StopRecording() != VyEngine::ErrorCode::Success) {
+		printf("%s\n", sdl.ErrorMessage.c_str());
 	}
 	sdl.Release();
 	return 0;
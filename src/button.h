@@ -6,7 +6,7 @@
 #include <functional>
 #include "helper.h"
 
-class Button : public VyInterface, public SelectableRect, public VyDrawable, public VyUpdatable {
+class Button : public VyInterface, public SelectableRect, public VyDrawable, public VyUpdatable, public VyPointerTarget, public HasRect {
 public:
 	enum class State { Normal, Hovered, Clicked, Selected, HoveredSelected };
 	class Colors {
@@ -27,12 +27,13 @@ private:
 	Button::State _buttonState;
 	int color;
 	bool held;
+	bool hovered;
 public:
 	Colors Colors;
 
 	Button() : Button({ 0, 0, 10, 10 }) {}
 
-	Button(SDL_Rect rect) : SelectableRect(rect), _buttonState(State::Normal), Colors(), held(false), color(0) {
+	Button(SDL_Rect rect) : SelectableRect(rect), _buttonState(State::Normal), Colors(), held(false), hovered(false), color(0) {
 		onPress = Nothing;
 		onRelease = Nothing;
 		Register();
@@ -45,34 +46,37 @@ public:
 	virtual VyEventProcessor* AsEventProcessor() { return this; }
 	virtual VyDrawable* AsDrawable() { return this; }
 	virtual VyUpdatable* AsUpdatable() { return this; }
+	virtual HasRect* AsRect() { return this; }
+	virtual Rect* GetRect() { return this; }
+	/// <summary>
+	/// through SetRect, so navigation and the pointer target follow
+	/// </summary>
+	virtual void MoveRectTo(const Coord& position) { MoveTo(position); }
 
 	void Register() {
 		VyEngine* sdl = VyEngine::GetInstance();
-		sdl->RegisterMouseDown(SDL_MOUSE_MAINCLICK, (size_t)this, [&](SDL_Event e) { HandleEvent(e); });
-		sdl->RegisterMouseUp(SDL_MOUSE_MAINCLICK, (size_t)this, [&](SDL_Event e) { HandleEvent(e); });
+		sdl->RegisterPointerTarget(this, *this);
 		sdl->RegisterDrawable(this);
 		sdl->RegisterUpdatable(this);
 	}
 
 	void Unregister() {
 		VyEngine* sdl = VyEngine::GetInstance();
-		sdl->UnregisterMouseDown(SDL_MOUSE_MAINCLICK, (size_t)this);
-		sdl->UnregisterMouseUp(SDL_MOUSE_MAINCLICK, (size_t)this);
+		sdl->UnregisterPointerTarget(this);
 		sdl->UnregisterDrawable(this);
 		sdl->UnregisterUpdatable(this);
 	}
 
-	virtual void HandleEvent(const SDL_Event& e) {
+	virtual void HandlePointerEvent(const SDL_Event& e) {
+		if (e.button.button != SDL_BUTTON_LEFT) {
+			return;
+		}
 		switch (e.button.state) {
-		case SDL_PRESSED: {
-			bool mouseOver = IsContains(VyEngine::GetInstance()->MousePosition);
-			_selected = mouseOver;
-			if (mouseOver) {
-				held = true;
-				_buttonState = State::Clicked;
-				onPress();
-			}
-			}break;
+		case SDL_PRESSED:
+			held = true;
+			_buttonState = State::Clicked;
+			onPress();
+			break;
 		case SDL_RELEASED:
 			if (held) {
 				held = false;
@@ -82,9 +86,14 @@ public:
 		}
 	}
 
+	virtual void SetHovered(bool isHovered) { hovered = isHovered; }
+
+	virtual void SetPointerFocused(bool focused) { SetSelectedNoNotify(focused); }
+
 	static void Nothing() {}
 
 	void UpdateColor() {
+		int previous = color;
 		switch (_buttonState) {
 		case State::Normal: color = Colors.normal; break;
 		case State::Hovered: color = Colors.hover; break;
@@ -92,9 +101,31 @@ public:
 		case State::Selected: color = Colors.selected; break;
 		case State::HoveredSelected: color = Colors.hoveredSelected; break;
 		}
+		if (color != previous) {
+			SDL_Rect bounds;
+			GetDrawBounds(bounds);
+			VyEngine::GetInstance()->AddDamage(bounds);
+		}
+	}
+
+	/// <summary>
+	/// the rect, and the navigation lines reaching out of it
+	/// </summary>
+	virtual bool GetDrawBounds(SDL_Rect& out_bounds) {
+		out_bounds = *this;
+		Coord center = GetCenter();
+		for (int i = 0; i < (int)Rect::Dir::Count; ++i) {
+			if (_next[i] == NULL) {
+				continue;
+			}
+			Coord other = center + (_next[i]->GetCenter() - center) / 2;
+			SDL_Rect end = { other.x, other.y, 1, 1 };
+			SDL_UnionRect(&out_bounds, &end, &out_bounds);
+		}
+		return true;
 	}
 
-	virtual void Draw(SDL_Renderer* g) {
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) {
 		if (!_active) {
 			// TODO when deactivated, remove it from the list instead.
 			return;
@@ -103,10 +134,26 @@ public:
 		SDL_GetRenderDrawColor(g, &oldColor);
 		UpdateColor();
 		SDL_SetRenderDrawColor(g, color);
-		RenderFillRect(g);
-		SDL_SetRenderDrawColor(g, 0xff00ff00);
-		DrawNavigation(g);
+		SDL_Rect area = { x + offset.x, y + offset.y, w, h };
+		SDL_RenderFillRect(g, &area);
 		SDL_SetRenderDrawColor(g, oldColor);
+		VyPrimitiveBatch* overlay = VyEngine::GetInstance()->GetPrimitiveBatch();
+		if (overlay != NULL) {
+			DrawNavigation(*overlay);
+		} else {
+			DrawNavigation(g, offset);
+		}
+	}
+
+	virtual bool Record(VyRenderQueue& queue) {
+		if (!_active) {
+			return true;
+		}
+		UpdateColor();
+		queue.FillRect(*this, VyRenderQueue::ToColor(color));
+		// over every drawable, like the primitive batch overlay Draw uses
+		RecordNavigation(queue, VyRenderQueue::MaxLayer);
+		return true;
 	}
 
 	virtual void Update() {
@@ -115,12 +162,8 @@ public:
 			return;
 		}
 		VyEngine* engine = VyEngine::GetInstance();
-		bool mouseOver = IsContains(engine->MousePosition);
-		//printf("%d, %d,     %d %d\n", engine->MousePosition.x, engine->MousePosition.y, mouseOver, isPressed);
-		if (mouseOver) {
-			bool isPressed = false;
-			engine->IsPressed(SDL_MOUSE_MAINCLICK, isPressed);
-			if (isPressed) {
+		if (hovered) {
+			if (engine->GetInput().IsMouseHeld(SDL_BUTTON_LEFT)) {
 				_buttonState = State::Clicked;
 			} else if (_selected) {
 				_buttonState = State::HoveredSelected;
@@ -137,6 +180,20 @@ public:
 		UpdateColor();
 	}
 
+protected:
+	virtual void OnRectChanged() {
+		VyEngine::GetInstance()->MovePointerTarget(this, *this);
+	}
+
+	virtual void OnActiveChanged() {
+		VyEngine* engine = VyEngine::GetInstance();
+		engine->SetPointerTargetActive(this, _active);
+		SDL_Rect bounds;
+		GetDrawBounds(bounds);
+		engine->AddDamage(bounds);
+	}
+
+public:
 	// TODO rename to something... like ConstantName.. or something. I dunno. I am sleepy.
 	const std::string _NAME = std::string(nameof(SdlButton));
 
@@ -3,11 +3,12 @@
 #include <memory>
 #include <functional>
 #include "vyobjectcommonbase.h"
+#include "vyobjectpool.h"
 
 class VyComponentContainerInterface : public VyUpdatable, public VyDrawable, public VyEventProcessor {
 public:
 	virtual void Update() = 0;
-	virtual void Draw(SDL_Renderer* g) = 0;
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) = 0;
 	virtual void AddComponent(std::shared_ptr<VyInterface> ptr) = 0;
 	virtual int GetUpdateCount() const = 0;
 	virtual int GetDrawCount() const = 0;
@@ -41,6 +42,10 @@ public:
 //	// TODO remove, get(index), get(type), getAll(type)
 //};
 
+/// <summary>
+/// components of any kind, each its own heap object called through its interfaces.
+/// for many entities made of the same plain-data components, <see cref="VyComponentStore"/> iterates much faster
+/// </summary>
 class VyComponentContainer : public VyComponentContainerInterface {
 private:
 	//ComponentContainer<VyUpdatable> _update;
@@ -48,9 +53,15 @@ private:
 	std::vector<VyUpdatable*> _updatable;
 	std::vector<VyDrawable*> _drawable;
 	std::vector<VyEventProcessor*> _eventProcessors;
+	/// <summary>GetEventMask of each of _eventProcessors</summary>
+	std::vector<Uint32> _eventMasks;
+	/// <summary>every mask in _eventMasks together</summary>
+	Uint32 _eventMask;
 	std::vector<std::shared_ptr<VyInterface>> _list;
+	/// <summary>updatable components that aren't IsParallelSafe</summary>
+	int _serialUpdatables;
 public:
-	VyComponentContainer() {}
+	VyComponentContainer() : _eventMask(0), _serialUpdatables(0) {}
 	~VyComponentContainer() {
 		_updatable.clear();
 		_drawable.clear();
@@ -61,21 +72,32 @@ public:
 			i->Update();
 		}
 	}
-	void Draw(SDL_Renderer* g) {
+	void Draw(SDL_Renderer* g, const Coord& offset) {
 		for (auto i : _drawable) {
-			i->Draw(g);
+			i->Draw(g, offset);
 		}
 	}
 	void HandleEvent(const SDL_Event& e) {
-		for (auto i : _eventProcessors) {
-			i->HandleEvent(e);
+		Uint32 category = Mask(GetCategory(e.type));
+		if ((_eventMask & category) == 0) { return; }
+		for (size_t i = 0; i < _eventProcessors.size(); ++i) {
+			if ((_eventMasks[i] & category) != 0) {
+				_eventProcessors[i]->HandleEvent(e);
+			}
 		}
 	}
+	/// <summary>
+	/// what any component subscribes to, as of when the container was registered
+	/// </summary>
+	virtual Uint32 GetEventMask() const { return _eventMask; }
 	void AddComponent(std::shared_ptr<VyInterface> ptr) {
 		_list.push_back(ptr);
 		VyUpdatable* updatable = ptr->AsUpdatable();
 		if (updatable) {
 			_updatable.push_back(updatable);
+			if (!updatable->IsParallelSafe()) {
+				++_serialUpdatables;
+			}
 		}
 		VyDrawable* drawable = ptr->AsDrawable();
 		if (drawable) {
@@ -84,8 +106,23 @@ public:
 		VyEventProcessor* eventable = ptr->AsEventProcessor();
 		if (eventable) {
 			_eventProcessors.push_back(eventable);
+			_eventMasks.push_back(eventable->GetEventMask());
+			_eventMask |= _eventMasks.back();
 		}
 	}
+	/// <summary>
+	/// creates the component in T's shared <see cref="VyObjectPool"/>, one pooled block instead of two heap allocations, and adds it
+	/// </summary>
+	template<typename T, typename... Args>
+	std::shared_ptr<T> AddComponent(Args&&... args) {
+		std::shared_ptr<T> component = VyObjectPool<T>::GetShared().Spawn(std::forward<Args>(args)...);
+		AddComponent(std::shared_ptr<VyInterface>(component));
+		return component;
+	}
 	virtual int GetUpdateCount() const { return (int)_updatable.size(); }
 	virtual int GetDrawCount() const { return (int)_drawable.size(); }
+	/// <summary>
+	/// when all of its components are, so a container's components update together on one worker
+	/// </summary>
+	virtual bool IsParallelSafe() const { return _serialUpdatables == 0; }
 };
@@ -175,4 +175,8 @@ public:
 class HasRect {
 public:
 	virtual Rect* GetRect() = 0;
+	/// <summary>
+	/// moves the rect without resizing it, as a parent <see cref="VyHierarched"/> does. override to tell whatever tracks the rect
+	/// </summary>
+	virtual void MoveRectTo(const Coord& position) { GetRect()->SetPosition(position); }
 };
@@ -7,10 +7,14 @@
 #include "componentcontainer.h"
 #include "sdlhierarchied.h"
 
+/// <summary>
+/// spawn with <see cref="SdlGameObject::Spawn"/> and add components with AddComponent&lt;T&gt; to keep objects and components in pools.
+/// components and children live in the object's <see cref="VyHierarched"/> node: rect components are placed relative to the object,
+/// and updating or drawing a root object reaches its whole tree
+/// </summary>
 class SdlGameObject : public VyInterface, public VyComponentContainerInterface, public VyHierarchedInterface {
 public:
 private:
-	VyComponentContainer _container;
 	VyHierarched _hierarchy;
 public:
 	SdlGameObject(std::string name) : _hierarchy(name) {}
@@ -20,22 +24,28 @@ public:
 	virtual std::shared_ptr <VyHierarchedInterface> GetChild(int index) { return _hierarchy.GetChild(index); }
 	virtual std::shared_ptr<VyHierarchedInterface> GetParent() const { return _hierarchy.GetParent(); }
 	virtual void SetParent(std::shared_ptr<VyHierarchedInterface> parent) { _hierarchy.SetParent(parent); }
-	virtual void Update() {
-		_container.Update();
-		_hierarchy.Update();
-	}
-	virtual void Draw(SDL_Renderer* g) {
-		_container.Draw(g);
-		_hierarchy.Draw(g);
-	}
-	virtual void HandleEvent(const SDL_Event& e) {
-		_container.HandleEvent(e);
-		_hierarchy.HandleEvent(e);
-	}
-	void AddComponent(std::shared_ptr<VyInterface> ptr) { _container.AddComponent(ptr); }
-	virtual int GetUpdateCount() const { return _container.GetUpdateCount(); }
-	virtual int GetDrawCount() const { return _container.GetDrawCount(); }
+	void AddChild(std::shared_ptr<SdlGameObject> child) { _hierarchy.AddChild(child, &child->_hierarchy); }
+	void RemoveChild(int index) { _hierarchy.RemoveChild(index); }
+	VyHierarched& GetHierarchy() { return _hierarchy; }
+	const Coord& GetLocalPosition() const { return _hierarchy.GetLocalPosition(); }
+	void SetLocalPosition(const Coord& position) { _hierarchy.SetLocalPosition(position); }
+	const Coord& GetWorldPosition() const { return _hierarchy.GetWorldPosition(); }
+	virtual void Update() { _hierarchy.Update(); }
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) { _hierarchy.Draw(g, offset); }
+	virtual void HandleEvent(const SDL_Event& e) { _hierarchy.HandleEvent(e); }
+	virtual Uint32 GetEventMask() const { return _hierarchy.GetEventMask(); }
+	void AddComponent(std::shared_ptr<VyInterface> ptr) { _hierarchy.AddComponent(ptr); }
+	template<typename T, typename... Args>
+	std::shared_ptr<T> AddComponent(Args&&... args) { return _hierarchy.AddComponent<T>(std::forward<Args>(args)...); }
+	virtual int GetUpdateCount() const { return _hierarchy.GetUpdateCount(); }
+	virtual int GetDrawCount() const { return _hierarchy.GetDrawCount(); }
+	virtual bool IsParallelSafe() const { return _hierarchy.IsParallelSafe(); }
 	virtual VyEventProcessor* AsEventProcessor() { return this; }
 	virtual VyDrawable* AsDrawable() { return this; }
 	virtual VyUpdatable* AsUpdatable() { return this; }
+	virtual HasRect* AsRect() { return nullptr; }
+	/// <summary>
+	/// a new game object from the shared pool. it goes back to the pool when the last reference is dropped
+	/// </summary>
+	static std::shared_ptr<SdlGameObject> Spawn(std::string name) { return VyObjectPool<SdlGameObject>::GetShared().Spawn(name); }
 };
@@ -1,6 +1,4 @@
 #pragma once
 #include "sdlhelper.h"
 
-short * CIRCLE_VALUES = NULL;
-short CIRCLE_VALUECOUNT = 0;
-short CIRCLE_VALUEALLOC = 0;
+thread_local VyPrimitiveBatch CIRCLE_BATCH(NULL);
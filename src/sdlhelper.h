@@ -1,6 +1,8 @@
 #pragma once
 #include <SDL.h>
 #include <stdio.h>
+#include "vyprimitivebatch.h"
+#include "vycircleprofile.h"
 
 typedef enum {
 	SDL_MOUSE_MAINCLICK = SDL_MOUSEMOTION +1,
@@ -19,144 +21,150 @@ inline void SDL_GetRenderDrawColor(SDL_Renderer* renderer, long* rgba) {
 	*rgba = *((long*)c);
 }
 
-extern short* CIRCLE_VALUES;
-extern short CIRCLE_VALUECOUNT;
-extern short CIRCLE_VALUEALLOC;
-
 /// <summary>
-/// Calculate curve so full data can be used to prevent overdraw
+/// one per thread, so SDL_DrawCircle and SDL_FillCircle share nothing between threads
 /// </summary>
-/// <param name="cx"></param>
-/// <param name="cy"></param>
-/// <param name="radius"></param>
-inline void CalculateCircleData(float cx, float cy, float radius) {
-	bool allocated = false;
-	if (CIRCLE_VALUES == NULL || CIRCLE_VALUEALLOC < radius * 1.5f) {
-		if (CIRCLE_VALUES != NULL) {
-			delete[] CIRCLE_VALUES;
-		}
-		CIRCLE_VALUEALLOC = (int)(radius * 1.5f + 1);
-		CIRCLE_VALUES = new short[CIRCLE_VALUEALLOC];
-		allocated = true;
-	}
-	const int diameter = (int)(radius * 2);
-	int x = (int)(radius - 1), y = 0, tx = 1, ty = 1, error = (tx - diameter);
-	int index = 0;
-	CIRCLE_VALUECOUNT = 0;
-	while (x >= y) {
-#ifndef NDEBUG
-		if (index + 1 >= CIRCLE_VALUEALLOC) {
-			printf("OVERRUN!");
-			return;
-		}
-#endif
-		CIRCLE_VALUES[index + 0] = (short)x;
-		CIRCLE_VALUES[index + 1] = (short)y;
-		index += 2;
-		if (error <= 0) { ++y; error += ty; ty += 2; }
-		if (error > 0) { --x; tx += 2; error += (tx - diameter); }
-		CIRCLE_VALUECOUNT += 2;
-	}
-	if (allocated) {
-		//printf("---- %d\n", CIRCLE_VALUECOUNT);
-		//for (int i = 0; i < CIRCLE_VALUECOUNT; i += 2) {
-		//	printf("%d: %d %d\n", i, CIRCLE_VALUES[i + 0], CIRCLE_VALUES[i + 1]);
-		//}
-	}
-}
+extern thread_local VyPrimitiveBatch CIRCLE_BATCH;
 
-/// <param name="renderer"></param>
+/// <summary>
+/// outline pixels of a circle, as points in the target
+/// </summary>
+/// <param name="target">a <see cref="VyPrimitiveBatch"/>, or anything else with FillSpan, FillColumn and Point</param>
 /// <param name="cx">center X</param>
 /// <param name="cy">center Y</param>
 /// <param name="radius"></param>
-inline void SDL_DrawCircle(SDL_Renderer* renderer, float cx, float cy, float radius) {
-	CalculateCircleData(cx, cy, radius);
+template<typename Target>
+inline void VyDrawCircle(Target& target, float cx, float cy, float radius) {
+	VyCircleProfile profile = VyCircleProfile::Get(radius);
+	if (profile.IsEmpty()) { return; }
+	const int* values = profile.values;
 	int x, y, cursor, nextCursor, minPoint, maxPoint;
 	// middle
-	for (int index = 0; index < CIRCLE_VALUECOUNT; index += 2) {
-		x = CIRCLE_VALUES[index + 0];
-		y = CIRCLE_VALUES[index + 1];
+	for (int index = 0; index < profile.count; index += 2) {
+		x = values[index + 0];
+		y = values[index + 1];
 		minPoint = (int)(cx - x); maxPoint = (int)(cx + x);
 		cursor = (int)(cy - y);
-		SDL_RenderDrawPoint(renderer, minPoint, cursor);
-		SDL_RenderDrawPoint(renderer, maxPoint, cursor);
+		target.Point(minPoint, cursor);
+		target.Point(maxPoint, cursor);
 		nextCursor = (int)(cy + y);
 		if (cursor != nextCursor) {
-			SDL_RenderDrawPoint(renderer, minPoint, nextCursor);
-			SDL_RenderDrawPoint(renderer, maxPoint, nextCursor);
+			target.Point(minPoint, nextCursor);
+			target.Point(maxPoint, nextCursor);
 		}
 	}
 	// top
-	maxPoint = (int)(cy - CIRCLE_VALUES[CIRCLE_VALUECOUNT - 1] - 1);
-	for (int index = 0; index < CIRCLE_VALUECOUNT; index += 2) {
-		x = CIRCLE_VALUES[index + 0];
-		y = CIRCLE_VALUES[index + 1];
+	for (int index = 0; index < profile.count; index += 2) {
+		x = values[index + 0];
+		y = values[index + 1];
 		minPoint = (int)(cy - x);
 		cursor = (int)(cx - y);
-		SDL_RenderDrawPoint(renderer, cursor, minPoint);
+		target.Point(cursor, minPoint);
 		nextCursor = (int)(cx + y);
 		if (cursor != nextCursor) {
-			SDL_RenderDrawPoint(renderer, nextCursor, minPoint);
+			target.Point(nextCursor, minPoint);
 		}
 	}
 	// bottom
-	minPoint = (int)(cy + CIRCLE_VALUES[CIRCLE_VALUECOUNT - 1] + 1);
-	for (int index = 0; index < CIRCLE_VALUECOUNT; index += 2) {
-		x = CIRCLE_VALUES[index + 0];
-		y = CIRCLE_VALUES[index + 1];
+	for (int index = 0; index < profile.count; index += 2) {
+		x = values[index + 0];
+		y = values[index + 1];
 		maxPoint = (int)(cy + x);
 		cursor = (int)(cx - y);
-		SDL_RenderDrawPoint(renderer, cursor, maxPoint);
+		target.Point(cursor, maxPoint);
 		nextCursor = (int)(cx + y);
 		if (cursor != nextCursor) {
-			SDL_RenderDrawPoint(renderer, nextCursor, maxPoint);
+			target.Point(nextCursor, maxPoint);
 		}
 	}
 }
 
-/// <param name="renderer"></param>
+/// <summary>
+/// a filled circle, as spans in the target
+/// </summary>
+/// <param name="target">a <see cref="VyPrimitiveBatch"/>, or anything else with FillSpan, FillColumn and Point</param>
 /// <param name="cx">center X</param>
 /// <param name="cy">center Y</param>
 /// <param name="radius"></param>
-inline void SDL_FillCircle(SDL_Renderer* renderer, float cx, float cy, float radius) {
-	CalculateCircleData(cx, cy, radius);
+template<typename Target>
+inline void VyFillCircle(Target& target, float cx, float cy, float radius) {
+	VyCircleProfile profile = VyCircleProfile::Get(radius);
+	if (profile.IsEmpty()) { return; }
+	const int* values = profile.values;
 	int x, y, cursor, nextCursor, minPoint, maxPoint;
 	// fill majority horizontal band in the center
-	for (int index = 0; index < CIRCLE_VALUECOUNT; index += 2) {
-		x = CIRCLE_VALUES[index + 0];
-		y = CIRCLE_VALUES[index + 1];
+	for (int index = 0; index < profile.count; index += 2) {
+		x = values[index + 0];
+		y = values[index + 1];
 		minPoint = (int)(cx - x); maxPoint = (int)(cx + x);
 		cursor = (int)(cy - y);
-		SDL_RenderDrawLine(renderer, minPoint, cursor, maxPoint, cursor);
+		target.FillSpan(minPoint, maxPoint, cursor);
 		nextCursor = (int)(cy + y);
 		if (cursor != nextCursor) {
-			SDL_RenderDrawLine(renderer, minPoint, nextCursor, maxPoint, nextCursor);
+			target.FillSpan(minPoint, maxPoint, nextCursor);
 		}
 	}
 	// fill top section
-	maxPoint = (int)(cy - CIRCLE_VALUES[CIRCLE_VALUECOUNT - 1] - 1);
-	for (int index = 0; index < CIRCLE_VALUECOUNT; index += 2) {
-		x = CIRCLE_VALUES[index + 0];
-		y = CIRCLE_VALUES[index + 1];
+	maxPoint = (int)(cy - profile.GetLastY() - 1);
+	for (int index = 0; index < profile.count; index += 2) {
+		x = values[index + 0];
+		y = values[index + 1];
 		minPoint = (int)(cy - x);
 		cursor = (int)(cx - y);
-		SDL_RenderDrawLine(renderer, cursor, minPoint, cursor, maxPoint);
+		target.FillColumn(cursor, minPoint, maxPoint);
 		nextCursor = (int)(cx + y);
 		if (cursor != nextCursor) {
-			SDL_RenderDrawLine(renderer, nextCursor, minPoint, nextCursor, maxPoint);
+			target.FillColumn(nextCursor, minPoint, maxPoint);
 		}
 	}
 	// fill bottom section
-	minPoint = (int)(cy + CIRCLE_VALUES[CIRCLE_VALUECOUNT - 1] + 1);
-	for (int index = 0; index < CIRCLE_VALUECOUNT; index += 2) {
-		x = CIRCLE_VALUES[index + 0];
-		y = CIRCLE_VALUES[index + 1];
+	minPoint = (int)(cy + profile.GetLastY() + 1);
+	for (int index = 0; index < profile.count; index += 2) {
+		x = values[index + 0];
+		y = values[index + 1];
 		maxPoint = (int)(cy + x);
 		cursor = (int)(cx - y);
-		SDL_RenderDrawLine(renderer, cursor, minPoint, cursor, maxPoint);
+		target.FillColumn(cursor, minPoint, maxPoint);
 		nextCursor = (int)(cx + y);
 		if (cursor != nextCursor) {
-			SDL_RenderDrawLine(renderer, nextCursor, minPoint, nextCursor, maxPoint);
+			target.FillColumn(nextCursor, minPoint, maxPoint);
 		}
 	}
 }
+
+/// <summary>
+/// the batch behind SDL_DrawCircle and SDL_FillCircle, in the renderer's current draw color
+/// </summary>
+inline VyPrimitiveBatch& GetCircleBatch(SDL_Renderer* renderer) {
+	CIRCLE_BATCH.SetRenderer(renderer);
+	SDL_Color color;
+	SDL_GetRenderDrawColor(renderer, &color.r, &color.g, &color.b, &color.a);
+	CIRCLE_BATCH.SetColor(color);
+	return CIRCLE_BATCH;
+}
+
+/// <summary>
+/// drawn right away, with one SDL_RenderDrawPoints call
+/// </summary>
+/// <param name="renderer"></param>
+/// <param name="cx">center X</param>
+/// <param name="cy">center Y</param>
+/// <param name="radius"></param>
+inline void SDL_DrawCircle(SDL_Renderer* renderer, float cx, float cy, float radius) {
+	VyPrimitiveBatch& batch = GetCircleBatch(renderer);
+	VyDrawCircle(batch, cx, cy, radius);
+	batch.Flush();
+}
+
+/// <summary>
+/// drawn right away, with one SDL_RenderFillRects call
+/// </summary>
+/// <param name="renderer"></param>
+/// <param name="cx">center X</param>
+/// <param name="cy">center Y</param>
+/// <param name="radius"></param>
+inline void SDL_FillCircle(SDL_Renderer* renderer, float cx, float cy, float radius) {
+	VyPrimitiveBatch& batch = GetCircleBatch(renderer);
+	VyFillCircle(batch, cx, cy, radius);
+	batch.Flush();
+}
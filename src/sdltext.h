@@ -4,18 +4,26 @@
 #include <string>
 #include "vyengine.h"
 #include "vyobjectcommonbase.h"
+#include "vyglyphcache.h"
+#include "vyspritebatch.h"
+#include "vyrenderqueue.h"
 
 // TODO implement scrolling function that moves the _srcRect
 // TODO test me
-class SdlText : public VyObjectCommonBase, public VyDrawable {
+class SdlText : public VyObjectCommonBase, public VyDrawable, public HasRect {
 public:
 	SDL_Texture* SdlTexture;
 	Rect _srcRect;
 	Rect _destRect;
+	/// <summary>
+	/// if set, text is drawn from these cached glyphs instead of SdlTexture, and SetText doesn't create a texture
+	/// </summary>
+	VyGlyphCache* _glyphs;
+	SDL_Color _color;
 
 	SdlText(std::string text) : SdlText(text, "", -1) { }
 
-	SdlText(std::string text, std::string font, int size) : VyObjectCommonBase(text), SdlTexture(NULL), _srcRect(), _destRect() {
+	SdlText(std::string text, std::string font, int size) : VyObjectCommonBase(text), SdlTexture(NULL), _srcRect(), _destRect(), _glyphs(NULL), _color() {
 		SetText(text, font, size);
 		// TODO make a smarter way to register, so that objects that are contained are removed from the engine list, and haandled as child objects
 		VyEngine::GetInstance()->RegisterDrawable(this); 
@@ -33,6 +41,8 @@ public:
 	virtual VyEventProcessor* AsEventProcessor() { return nullptr; }
 	virtual VyDrawable* AsDrawable() { return this; }
 	virtual VyUpdatable* AsUpdatable() { return nullptr; }
+	virtual HasRect* AsRect() { return this; }
+	virtual Rect* GetRect() { return &_destRect; }
 
 	const std::string& GetName() const { return VyObjectCommonBase::GetName(); }
 	const std::string& GetText() const { return GetName(); }
@@ -40,6 +50,24 @@ public:
 	Rect& DestRect() { return _destRect; }
 	Rect& SrcRect() { return _srcRect; }
 
+	bool IsGlyphMode() const { return _glyphs != NULL; }
+
+	/// <summary>
+	/// glyph mode suits text that changes every frame (counters, timers): changing it only re-measures.
+	/// SrcRect is ignored in glyph mode
+	/// </summary>
+	void SetGlyphMode(bool useGlyphs) {
+		VyEngine* engine = VyEngine::GetInstance();
+		VyGlyphCache* glyphs = useGlyphs ? engine->GetGlyphCache() : NULL;
+		if (glyphs == _glyphs) { return; }
+		if (SdlTexture != NULL) {
+			engine->ReleaseSdlTexture(SdlTexture);
+			SdlTexture = NULL;
+		}
+		_glyphs = glyphs;
+		SetText(GetText(), "", -1);
+	}
+
 	void SetText(std::string text, std::string font, int fontSize) {
 		VyEngine* engine = VyEngine::GetInstance();
 		bool setFont = font != "";
@@ -52,7 +80,17 @@ public:
 		if (SdlTexture != NULL) {
 			engine->ReleaseSdlTexture(SdlTexture);
 		}
+		// the old text's area. a bigger new one is picked up by GetDrawBounds changing
+		engine->AddDamage(_destRect);
 		SetName(text);
+		if (_glyphs != NULL) {
+			SDL_GetRenderDrawColor(engine->GetRenderer(), &_color.r, &_color.g, &_color.b, &_color.a);
+			Coord size = _glyphs->Measure(GetText());
+			engine->FailFast();
+			_destRect.SetSize(size);
+			_srcRect.SetSize(size);
+			return;
+		}
 		if (GetText().length() == 0) {
 			SdlTexture = NULL;
 			_destRect.SetSize(0, 0);
@@ -65,7 +103,29 @@ public:
 		_srcRect.SetSize(size);
 	}
 
-	virtual void Draw(SDL_Renderer* g) {
-		SDL_RenderCopy(g, SdlTexture, &_srcRect, &_destRect);
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) {
+		if (_glyphs != NULL) {
+			// flushed here so the text keeps its place among drawables that draw directly
+			VySpriteBatch* batch = VyEngine::GetInstance()->GetSpriteBatch();
+			_glyphs->Draw(*batch, GetText(), _destRect.GetPosition(), _color);
+			batch->Flush();
+			return;
+		}
+		SDL_Rect dest = { _destRect.x + offset.x, _destRect.y + offset.y, _destRect.w, _destRect.h };
+		SDL_RenderCopy(g, SdlTexture, &_srcRect, &dest);
+	}
+
+	virtual bool GetDrawBounds(SDL_Rect& out_bounds) {
+		out_bounds = _destRect;
+		return true;
+	}
+
+	virtual bool Record(VyRenderQueue& queue) {
+		if (_glyphs != NULL) {
+			_glyphs->Record(queue, GetText(), _destRect.GetPosition(), _color);
+		} else {
+			queue.Texture(SdlTexture, &_srcRect, _destRect);
+		}
+		return true;
 	}
 };
@@ -3,10 +3,12 @@
 #include "vyengine.h"
 #include "sdlhelper.h"
 #include "sdleventprocessor.h"
+#include "vynavigation.h"
+#include "vyrenderqueue.h"
+#include "vyprimitivebatch.h"
 #include <functional>
 #include <algorithm>
 
-// TODO register self with VyEngine, and mark as needing navigation recalculation
 class SelectableRect : public Rect, public VyEventProcessor {
 protected:
 	bool _selected;
@@ -16,6 +18,11 @@ protected:
 	bool _navigatable;
 	bool _active;
 	SelectableRect* _next[(int)Rect::Dir::Count];
+	/// <summary>
+	/// the graph keeping _next up to date, told about moves and state changes. NULL if navigation is set up by hand
+	/// </summary>
+	VyNavigationGraph* _navigation;
+	friend class VyNavigationGraph;
 public:
 	VyEngine::EventDelegateKeyedList OnKeyEvent;
 	VyEngine::EventKeyedList OnSelected;
@@ -27,6 +34,7 @@ public:
 
 	void SetSelectedNoNotify(bool selected) {
 		_selected = selected;
+		UpdateSelection();
 	}
 
 	void SetSelected(bool selected) {
@@ -38,14 +46,71 @@ public:
 			}
 		}
 		_selected = selected;
+		UpdateSelection();
 	}
 
-	SelectableRect(SDL_Rect rect) : Rect(rect), _selected(false), _navigatable(true), _active(true), _next() {
+	SelectableRect(SDL_Rect rect) : Rect(rect), _selected(false), _navigatable(true), _active(true), _next(), _navigation(NULL) {
 		memset(_next, NULL, sizeof(_next));
 		OnKeyEvent[(size_t)this] = [this](SDL_Event e) { HandleNavigationKey(e); };
 		VyEngine::GetInstance()->RegisterProcessor(this);
 	}
 
+	virtual ~SelectableRect() {
+		if (_navigation != NULL) {
+			_navigation->Remove(this);
+		}
+		VyEngine* engine = VyEngine::GetInstance();
+		if (engine->GetSelection() == this) {
+			engine->SetSelection(NULL);
+		}
+		engine->UnregisterProcessor(this);
+	}
+
+	virtual void HandleEvent(const SDL_Event& e) {
+		ProcessInput(e);
+	}
+
+	/// <summary>
+	/// keys only: the mouse reaches buttons through the hit test. registered from the constructor, so a subclass that widens it calls <see cref="VyEngine::UpdateEventMask"/> from its own
+	/// </summary>
+	virtual Uint32 GetEventMask() const { return Mask(EventCategory::Keyboard); }
+
+	bool IsActive() const { return _active; }
+
+	void SetActive(bool active) {
+		if (active == _active) { return; }
+		_active = active;
+		if (_navigation != NULL) {
+			_navigation->Update(this);
+		}
+		OnActiveChanged();
+	}
+
+	bool IsNavigatable() const { return _navigatable; }
+
+	void SetNavigatable(bool navigatable) {
+		if (navigatable == _navigatable) { return; }
+		_navigatable = navigatable;
+		if (_navigation != NULL) {
+			_navigation->Update(this);
+		}
+	}
+
+	/// <summary>
+	/// moves/resizes and notifies subclasses. writing x/y/w/h directly skips <see cref="SelectableRect::OnRectChanged"/>
+	/// </summary>
+	void SetRect(const Rect& rect) {
+		x = rect.x; y = rect.y; w = rect.w; h = rect.h;
+		if (_navigation != NULL) {
+			_navigation->Update(this);
+		}
+		OnRectChanged();
+	}
+
+	void MoveTo(const Coord& position) {
+		SetRect(Rect(position, GetSize()));
+	}
+
 	virtual void ProcessInput(const SDL_Event& e) {
 		switch (e.type) {
 		case SDL_KEYDOWN:
@@ -85,7 +150,7 @@ public:
 		VyEngine::GetInstance()->Queue([this,next]() {
 			this->SetSelected(false);
 			next->SetSelected(true);
-		}, string_format(__FILE__ ":%d", __LINE__));
+		}, VY_HERE);
 	}
 
 	void SetNavigation(Rect::Dir dir, SelectableRect* nextRect) {
@@ -98,67 +163,44 @@ public:
 		}
 	}
 
-	struct CenterRect {
-		int pos;
-		int rect;
-	};
-
+	/// <summary>
+	/// links the rects once. use a <see cref="VyNavigationGraph"/> that outlives them to keep links updated as they change
+	/// </summary>
 	static void SetupNavigation(const std::vector<SelectableRect*>& rects) {
-		std::vector<Coord> centers;
-		centers.reserve(rects.size());
-		for (int i = 0; i < rects.size(); ++i) {
-			rects[i]->ClearNavigation();
-			Coord center = rects[i]->GetCenter();
-			centers.push_back(center);
-		}
-
-		std::function<bool(Coord delta)> CandidateVetting[(int)Rect::Dir::Count] = {
-			[](Coord delta) -> bool { return delta.y < 0 && abs(delta.x) <= abs(delta.y); }, // up
-			[](Coord delta) -> bool { return delta.x < 0 && abs(delta.x) >= abs(delta.y); }, // left
-			[](Coord delta) -> bool { return delta.y > 0 && abs(delta.x) <= abs(delta.y); }, // down
-			[](Coord delta) -> bool { return delta.x > 0 && abs(delta.x) >= abs(delta.y); }, // right
-		};
-
-		for (int dir = 0; dir < (int)Rect::Dir::Count; ++dir) {
-			for (int selfId = 0; selfId < centers.size(); ++selfId) {
-				int bestCandidate = GetBestNavigationCandidate(rects, centers, selfId, CandidateVetting[dir]);
-				if (bestCandidate >= 0) {
-					rects[selfId]->SetNavigation((Rect::Dir)dir, rects[bestCandidate]);
-				}
-			}
-		}
+		VyNavigationGraph graph;
+		graph.Build(rects);
 	}
 
-	static int GetBestNavigationCandidate(const std::vector<SelectableRect*>& rects, const std::vector<Coord>& centers, int selfId, std::function<bool(Coord delta)> initialCandidateVettingFunction) {
-		Coord selfCenter = centers[selfId];
-		int bestCandidate = -1;
-		float bestCandidateDistance = 0;
-		float distance;
-		for (int candidateId = 0; candidateId < centers.size(); ++candidateId) {
-			if (selfId == candidateId || !rects[candidateId]->_navigatable) {
-				continue;
-			}
-			Coord delta = centers[candidateId]  - selfCenter;
-			if (initialCandidateVettingFunction(delta)) {
-				distance = delta.MagnitudeSq();
-				if (bestCandidateDistance == 0 || distance < bestCandidateDistance) {
-					bestCandidateDistance = distance;
-					bestCandidate = candidateId;
-				}
+protected:
+	virtual void OnRectChanged() {}
+	/// <summary>
+	/// keeps the engine's one selection: selecting this unselects whatever was selected before
+	/// </summary>
+	void UpdateSelection() {
+		VyEngine* engine = VyEngine::GetInstance();
+		SelectableRect* previous = engine->GetSelection();
+		if (_selected) {
+			engine->SetSelection(this);
+			if (previous != NULL && previous != this) {
+				previous->SetSelectedNoNotify(false);
 			}
+		} else if (previous == this) {
+			engine->SetSelection(NULL);
 		}
-		return bestCandidate;
 	}
+	virtual void OnActiveChanged() {}
 
-	void DrawNavigation(SDL_Renderer* g) {
-		Coord center = GetCenter();
+public:
+	/// <param name="offset">added to world coordinates, as in <see cref="VyDrawable::Draw"/></param>
+	void DrawNavigation(SDL_Renderer* g, const Coord& offset) {
+		Coord center = GetCenter() + offset;
 		Coord other;
 		for (int i = 0; i < (int)Rect::Dir::Count; ++i) {
 			SelectableRect* next = _next[i];
 			if (next == NULL) {
 				continue;
 			}
-			other = next->GetCenter();
+			other = next->GetCenter() + offset;
 			Coord delta = other - center;
 			other = center + delta / 2;
 			int c = 0xff000000 | Rect::DirColor[i];
@@ -167,4 +209,35 @@ public:
 		}
 	}
 
+	/// <summary>
+	/// <see cref="SelectableRect::DrawNavigation"/> into a batch, so many rects' links cost one draw call
+	/// </summary>
+	void DrawNavigation(VyPrimitiveBatch& batch) {
+		Coord center = GetCenter();
+		for (int i = 0; i < (int)Rect::Dir::Count; ++i) {
+			SelectableRect* next = _next[i];
+			if (next == NULL) {
+				continue;
+			}
+			Coord other = center + (next->GetCenter() - center) / 2;
+			batch.SetColor((long)(0xff000000 | Rect::DirColor[i]));
+			batch.Line(center.x, center.y, other.x, other.y);
+		}
+	}
+
+	/// <summary>
+	/// <see cref="SelectableRect::DrawNavigation"/> as queued lines
+	/// </summary>
+	void RecordNavigation(VyRenderQueue& queue, int layer = 0) {
+		Coord center = GetCenter();
+		for (int i = 0; i < (int)Rect::Dir::Count; ++i) {
+			SelectableRect* next = _next[i];
+			if (next == NULL) {
+				continue;
+			}
+			Coord other = center + (next->GetCenter() - center) / 2;
+			queue.Line(center.x, center.y, other.x, other.y, VyRenderQueue::ToColor(0xff000000 | Rect::DirColor[i]), layer);
+		}
+	}
+
 };
@@ -0,0 +1,84 @@
+#include "vyactionqueue.h"
+#include "vyprofiler.h"
+
+VyActionQueue::VyActionQueue(int capacity) : _ring(), _mask(0), _writePosition(0), _readPosition(0), _overflow(), _hasOverflow(false), _overflowCount(0) {
+	size_t size = 2;
+	while (size < (size_t)capacity) { size *= 2; }
+	_ring.reset(new Slot[size]);
+	for (size_t i = 0; i < size; ++i) {
+		_ring[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	_mask = size - 1;
+}
+
+bool VyActionQueue::TryPush(Entry& entry) {
+	size_t position = _writePosition.load(std::memory_order_relaxed);
+	Slot* slot;
+	while (true) {
+		slot = &_ring[position & _mask];
+		size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+		if (difference == 0) {
+			if (_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (difference < 0) {
+			// the consumer hasn't read this slot since the last lap: full
+			return false;
+		} else {
+			position = _writePosition.load(std::memory_order_relaxed);
+		}
+	}
+	slot->entry.action = std::move(entry.action);
+	slot->entry.source = entry.source;
+	slot->entry.phase = entry.phase;
+	slot->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+void VyActionQueue::Post(Action action, VySourceLocation source, Phase phase) {
+	Entry entry = { std::move(action), source, phase };
+	if (TryPush(entry)) { return; }
+	std::lock_guard<std::mutex> lock(_overflowMutex);
+	_overflow.push_back(std::move(entry));
+	_hasOverflow = true;
+	++_overflowCount;
+}
+
+void VyActionQueue::Drain() {
+	while (true) {
+		Slot& slot = _ring[_readPosition & _mask];
+		size_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence != _readPosition + 1) {
+			// empty, or claimed but not yet written: the rest waits for the next drain
+			break;
+		}
+		_pending[(int)slot.entry.phase].push_back(std::move(slot.entry));
+		slot.entry.action.Reset();
+		slot.sequence.store(_readPosition + _mask + 1, std::memory_order_release);
+		++_readPosition;
+	}
+	if (_hasOverflow) {
+		std::lock_guard<std::mutex> lock(_overflowMutex);
+		_hasOverflow = false;
+		for (int i = 0; i < _overflow.size(); ++i) {
+			_pending[(int)_overflow[i].phase].push_back(std::move(_overflow[i]));
+		}
+		_overflow.clear();
+	}
+}
+
+int VyActionQueue::Service(Phase phase) {
+	Drain();
+	std::vector<Entry>& pending = _pending[(int)phase];
+	if (pending.empty()) { return 0; }
+	// swapped out first: actions that post for this phase wait for its next turn
+	_running.swap(pending);
+	int count = (int)_running.size();
+	for (int i = 0; i < count; ++i) {
+		VY_PROFILE_ZONE(_running[i].source.function);
+		_running[i].action();
+	}
+	_running.clear();
+	return count;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "vyinlinefunction.h"
+#include "vysourcelocation.h"
+
+/// <summary>
+/// actions deferred to a later point in the frame. any thread may post, without locks or allocation:
+/// posts go into a fixed ring of slots (a bounded MPSC queue, each slot claimed with a compare-and-swap and published with a sequence number),
+/// and the main thread drains it at each phase, running the actions meant for that phase.
+/// an action posted while its phase is running runs the next time that phase comes around.
+/// if the ring is full, posts spill into a locked overflow list, which keeps them but not their order relative to the ring
+/// </summary>
+class VyActionQueue {
+public:
+	/// <summary>
+	/// the points in <see cref="VyEngine::Run"/>'s frame where deferred actions run
+	/// </summary>
+	enum class Phase {
+		/// <summary>the start of the next frame, before its input is processed</summary>
+		NextFrame,
+		/// <summary>the end of ProcessInput, once this frame's input snapshot is published</summary>
+		AfterInput,
+		/// <summary>the end of Update, after every updatable: <see cref="VyEngine::ServiceQueue"/></summary>
+		Update,
+		/// <summary>the end of Render, after the frame is presented</summary>
+		EndOfFrame,
+		Count
+	};
+	/// <summary>lambdas capturing up to 6 pointers are stored without allocating</summary>
+	typedef VyInlineFunction<void(), 48> Action;
+private:
+	struct Entry {
+		Action action;
+		VySourceLocation source;
+		Phase phase;
+	};
+	struct Slot {
+		/// <summary>the position this slot can be written at when equal to it, and read at when one past it</summary>
+		std::atomic<size_t> sequence;
+		Entry entry;
+	};
+	std::unique_ptr<Slot[]> _ring;
+	size_t _mask;
+	/// <summary>producers race for this, on their own cache line</summary>
+	alignas(64) std::atomic<size_t> _writePosition;
+	/// <summary>only the consumer touches this</summary>
+	alignas(64) size_t _readPosition;
+	std::mutex _overflowMutex;
+	std::vector<Entry> _overflow;
+	/// <summary>so draining only locks when there is something in _overflow</summary>
+	std::atomic<bool> _hasOverflow;
+	std::atomic<int> _overflowCount;
+	/// <summary>drained from the ring, waiting for their phase. consumer only</summary>
+	std::vector<Entry> _pending[(int)Phase::Count];
+	std::vector<Entry> _running;
+public:
+	/// <param name="capacity">slots in the ring, rounded up to a power of two</param>
+	VyActionQueue(int capacity = 1024);
+	/// <summary>
+	/// safe from any thread
+	/// </summary>
+	void Post(Action action, VySourceLocation source, Phase phase = Phase::Update);
+	/// <summary>
+	/// runs every action posted for phase before this call. main thread only
+	/// </summary>
+	/// <returns>how many actions ran</returns>
+	int Service(Phase phase);
+	/// <summary>
+	/// posts that didn't fit in the ring since <see cref="VyActionQueue::ResetStats"/>. often nonzero means the ring is too small
+	/// </summary>
+	int GetOverflowCount() const { return _overflowCount; }
+	void ResetStats() { _overflowCount = 0; }
+private:
+	bool TryPush(Entry& entry);
+	/// <summary>
+	/// moves everything posted so far into _pending
+	/// </summary>
+	void Drain();
+};
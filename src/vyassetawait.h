@@ -0,0 +1,29 @@
+#pragma once
+#include "vyassetloader.h"
+
+#if __cpp_impl_coroutine
+#include <coroutine>
+
+/// <summary>
+/// co_await on a <see cref="VyAssetHandle"/>, for the coroutine direction in unifextest.h: a unifex::task (or any coroutine) awaits it directly,
+/// without depending on libunifex. the coroutine resumes on the main thread, in <see cref="VyEngine::ProcessAssetUploads"/>,
+/// so it can use the texture or font right away. it is never resumed if the engine is released first
+/// </summary>
+class VyAssetAwaiter {
+private:
+	VyAssetHandle _handle;
+public:
+	explicit VyAssetAwaiter(VyAssetHandle handle) : _handle(handle) {}
+	bool await_ready() const { return _handle.IsDone(); }
+	void await_suspend(std::coroutine_handle<> continuation) const {
+		_handle.OnDone([continuation]() { continuation.resume(); });
+	}
+	/// <returns>the handle, ready or failed</returns>
+	VyAssetHandle await_resume() const { return _handle; }
+};
+
+/// <summary>
+/// VyAssetHandle image = co_await engine->LoadSdlTextureAsync("img/helloworld.png");
+/// </summary>
+inline VyAssetAwaiter operator co_await(VyAssetHandle handle) { return VyAssetAwaiter(handle); }
+#endif
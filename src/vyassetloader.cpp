@@ -0,0 +1,136 @@
+#include "vyassetloader.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <chrono>
+#include "stringstuff.h"
+#include "vyprofiler.h"
+
+VyAssetLoader::VyAssetLoader(int workerCount) : _stopping(false), _inFlight(0) {
+	if (workerCount <= 0) {
+		workerCount = std::min(std::max(SDL_GetCPUCount() - 1, 1), 4);
+	}
+	for (int i = 0; i < workerCount; ++i) {
+		_workers.push_back(std::thread(&VyAssetLoader::WorkerLoop, this));
+	}
+}
+
+VyAssetLoader::~VyAssetLoader() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_queuedSignal.notify_all();
+	for (int i = 0; i < _workers.size(); ++i) {
+		_workers[i].join();
+	}
+	for (int i = 0; i < _decoded.size(); ++i) {
+		VyAssetRequest& request = *_decoded[i];
+		SDL_FreeSurface(request.surface);
+		request.surface = NULL;
+		SDL_free(request.fontData);
+		request.fontData = NULL;
+		request.error = "asset loader released before the asset was finished";
+		request.state = VyAssetRequest::State::Failed;
+	}
+	for (int i = 0; i < _queued.size(); ++i) {
+		_queued[i]->error = "asset loader released before the asset was decoded";
+		_queued[i]->state = VyAssetRequest::State::Failed;
+	}
+}
+
+void VyAssetLoader::Submit(std::shared_ptr<VyAssetRequest> request) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_queued.push_back(request);
+		++_inFlight;
+	}
+	_queuedSignal.notify_one();
+}
+
+bool VyAssetLoader::PopDecoded(std::shared_ptr<VyAssetRequest>& out_request) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_decoded.empty()) { return false; }
+	out_request = _decoded.front();
+	_decoded.pop_front();
+	--_inFlight;
+	return true;
+}
+
+void VyAssetLoader::WaitForDecoded(Uint32 timeoutMs) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_decodedSignal.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return !_decoded.empty(); });
+}
+
+int VyAssetLoader::GetInFlightCount() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _inFlight;
+}
+
+void VyAssetLoader::WorkerLoop() {
+	while (true) {
+		std::shared_ptr<VyAssetRequest> request;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_queuedSignal.wait(lock, [this]() { return _stopping || !_queued.empty(); });
+			if (_stopping) { return; }
+			request = _queued.front();
+			_queued.pop_front();
+		}
+		Decode(*request);
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_decoded.push_back(request);
+		}
+		_decodedSignal.notify_all();
+	}
+}
+
+bool VyAssetLoader::DecodeImage(const std::string& path, SDL_Surface*& out_surface, std::string& out_error) {
+	std::string lowercasePath = path;
+	std::transform(lowercasePath.begin(), lowercasePath.end(), lowercasePath.begin(), [](char c) { return (char)tolower(c); });
+	size_t dot = lowercasePath.rfind('.');
+	std::string extension = dot == std::string::npos ? "" : lowercasePath.substr(dot + 1);
+	if (extension == "bmp") {
+		out_surface = SDL_LoadBMP(path.c_str());
+	} else if (extension == "png") {
+		out_surface = IMG_Load(path.c_str());
+	} else {
+		out_error = string_format("Unable to load image format %s!\n", path.c_str());
+		return false;
+	}
+	if (out_surface == NULL) {
+		out_error = string_format("Failed to load image %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+void VyAssetLoader::Decode(VyAssetRequest& request) {
+	VY_PROFILE_ZONE("VyAssetLoader::Decode");
+	switch (request.kind) {
+	case VyAssetRequest::Kind::Surface:
+	case VyAssetRequest::Kind::Texture: {
+		SDL_Surface* loaded = NULL;
+		if (!DecodeImage(request.path, loaded, request.error)) {
+			break;
+		}
+		if (request.pixelFormat != 0 && loaded->format->format != request.pixelFormat) {
+			// converting here leaves only the upload for the main thread
+			request.surface = SDL_ConvertSurfaceFormat(loaded, request.pixelFormat, 0);
+			SDL_FreeSurface(loaded);
+			if (request.surface == NULL) {
+				request.error = string_format("Unable to optimize image %s! SDL Error: %s\n", request.path.c_str(), SDL_GetError());
+			}
+		} else {
+			request.surface = loaded;
+		}
+		}break;
+	case VyAssetRequest::Kind::Font:
+		request.fontData = SDL_LoadFile(request.path.c_str(), &request.fontDataSize);
+		if (request.fontData == NULL) {
+			request.error = string_format("could not load %s! SDL Error: %s\n", request.path.c_str(), SDL_GetError());
+		}
+		break;
+	}
+	request.state = VyAssetRequest::State::Decoded;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/// <summary>
+/// one asset moving through <see cref="VyAssetLoader"/>: decoded on a worker, then finished (uploaded/opened) on the main thread
+/// </summary>
+class VyAssetRequest {
+public:
+	enum class Kind { Surface, Texture, Font };
+	enum class State { Queued, Decoded, Ready, Failed };
+	Kind kind;
+	std::string path;
+	/// <summary>SDL_PIXELFORMAT_* the worker converts images to</summary>
+	Uint32 pixelFormat;
+	std::string fontName;
+	int fontSize;
+	std::atomic<State> state;
+	/// <summary>decoded image. for Kind::Texture, freed once uploaded</summary>
+	SDL_Surface* surface;
+	SDL_Texture* texture;
+	/// <summary>whole font file, read by the worker, for TTF_OpenFontRW</summary>
+	void* fontData;
+	size_t fontDataSize;
+	TTF_Font* font;
+	std::string error;
+	/// <summary>run on the main thread once Ready or Failed, by <see cref="VyEngine::ProcessAssetUploads"/>. main thread only</summary>
+	std::vector<std::function<void()>> onDone;
+	VyAssetRequest(Kind kind, std::string path) : kind(kind), path(path), pixelFormat(0), fontName(), fontSize(0), state(State::Queued),
+		surface(NULL), texture(NULL), fontData(NULL), fontDataSize(0), font(NULL), error(), onDone() {}
+	/// <summary>
+	/// runs and drops the onDone callbacks
+	/// </summary>
+	void NotifyDone() {
+		std::vector<std::function<void()>> callbacks;
+		callbacks.swap(onDone);
+		for (size_t i = 0; i < callbacks.size(); ++i) {
+			callbacks[i]();
+		}
+	}
+};
+
+/// <summary>
+/// pollable result of an async load. the resource belongs to <see cref="VyEngine"/>, like the synchronous loads
+/// </summary>
+class VyAssetHandle {
+private:
+	std::shared_ptr<VyAssetRequest> _request;
+public:
+	VyAssetHandle() : _request() {}
+	VyAssetHandle(std::shared_ptr<VyAssetRequest> request) : _request(request) {}
+	bool IsValid() const { return _request != nullptr; }
+	bool IsReady() const { return _request != nullptr && _request->state == VyAssetRequest::State::Ready; }
+	bool IsFailed() const { return _request != nullptr && _request->state == VyAssetRequest::State::Failed; }
+	bool IsDone() const { return IsReady() || IsFailed(); }
+	/// <returns>NULL until ready</returns>
+	SDL_Surface* GetSurface() const { return IsReady() ? _request->surface : NULL; }
+	SDL_Texture* GetTexture() const { return IsReady() ? _request->texture : NULL; }
+	TTF_Font* GetFont() const { return IsReady() ? _request->font : NULL; }
+	const std::string& GetError() const { return _request->error; }
+	/// <summary>
+	/// calls callback on the main thread once the asset is ready or failed, right away if it already is.
+	/// never called if the engine is released first. main thread only
+	/// </summary>
+	void OnDone(std::function<void()> callback) const {
+		if (IsDone()) {
+			callback();
+			return;
+		}
+		_request->onDone.push_back(std::move(callback));
+	}
+	const std::shared_ptr<VyAssetRequest>& GetRequest() const { return _request; }
+};
+
+/// <summary>
+/// worker threads that read and decode files off the main thread. decoded requests wait in a queue
+/// for the main thread to finish them, since textures and fonts must be created there
+/// </summary>
+class VyAssetLoader {
+private:
+	std::vector<std::thread> _workers;
+	std::deque<std::shared_ptr<VyAssetRequest>> _queued;
+	std::deque<std::shared_ptr<VyAssetRequest>> _decoded;
+	std::mutex _mutex;
+	std::condition_variable _queuedSignal;
+	std::condition_variable _decodedSignal;
+	bool _stopping;
+	/// <summary>requests submitted but not yet popped as decoded</summary>
+	int _inFlight;
+public:
+	/// <param name="workerCount">0 picks one less than the CPU count, at least 1 and at most 4</param>
+	VyAssetLoader(int workerCount = 0);
+	/// <summary>
+	/// stops the workers. surfaces and font data of requests never finished are freed
+	/// </summary>
+	~VyAssetLoader();
+	void Submit(std::shared_ptr<VyAssetRequest> request);
+	/// <returns>false if nothing is decoded yet</returns>
+	bool PopDecoded(std::shared_ptr<VyAssetRequest>& out_request);
+	/// <summary>
+	/// blocks until something is decoded, or the timeout passes
+	/// </summary>
+	void WaitForDecoded(Uint32 timeoutMs);
+	int GetInFlightCount();
+	int GetWorkerCount() const { return (int)_workers.size(); }
+	/// <summary>
+	/// loads a bmp or png. safe to call from any thread
+	/// </summary>
+	static bool DecodeImage(const std::string& path, SDL_Surface*& out_surface, std::string& out_error);
+private:
+	void WorkerLoop();
+	static void Decode(VyAssetRequest& request);
+};
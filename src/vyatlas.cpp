@@ -0,0 +1,152 @@
+#include "vyatlas.h"
+#include <algorithm>
+#include <climits>
+
+VySkylinePacker::VySkylinePacker(int width, int height) : _width(width), _height(height), _usedArea(0) {
+	Reset();
+}
+
+void VySkylinePacker::Reset() {
+	_skyline.clear();
+	_skyline.push_back({ 0, 0, _width });
+	_usedArea = 0;
+}
+
+float VySkylinePacker::GetOccupancy() const {
+	return (float)_usedArea / ((float)_width * _height);
+}
+
+int VySkylinePacker::Fit(int index, int w, int h) const {
+	int x = _skyline[index].x;
+	if (x + w > _width) { return -1; }
+	int y = 0;
+	int widthLeft = w;
+	for (int i = index; widthLeft > 0; ++i) {
+		y = std::max(y, _skyline[i].y);
+		if (y + h > _height) { return -1; }
+		widthLeft -= _skyline[i].w;
+	}
+	return y;
+}
+
+bool VySkylinePacker::Pack(int w, int h, Coord& out_position) {
+	if (w <= 0 || h <= 0) { return false; }
+	int bestIndex = -1, bestTop = INT_MAX, bestWidth = INT_MAX, bestY = 0;
+	for (int i = 0; i < _skyline.size(); ++i) {
+		int y = Fit(i, w, h);
+		if (y < 0) { continue; }
+		// lowest top first, then the narrowest segment, to keep the skyline flat
+		if (y + h < bestTop || (y + h == bestTop && _skyline[i].w < bestWidth)) {
+			bestIndex = i;
+			bestTop = y + h;
+			bestWidth = _skyline[i].w;
+			bestY = y;
+		}
+	}
+	if (bestIndex < 0) { return false; }
+	out_position = Coord(_skyline[bestIndex].x, bestY);
+	Place(bestIndex, out_position.x, bestY, w, h);
+	return true;
+}
+
+void VySkylinePacker::Place(int index, int x, int y, int w, int h) {
+	Segment top = { x, y + h, w };
+	_skyline.insert(_skyline.begin() + index, top);
+	// trim the segments now under the new one
+	for (int i = index + 1; i < _skyline.size(); ++i) {
+		const Segment& previous = _skyline[i - 1];
+		Segment& segment = _skyline[i];
+		int overlap = previous.x + previous.w - segment.x;
+		if (overlap <= 0) { break; }
+		segment.x += overlap;
+		segment.w -= overlap;
+		if (segment.w > 0) { break; }
+		_skyline.erase(_skyline.begin() + i);
+		--i;
+	}
+	for (int i = 0; i + 1 < _skyline.size(); ++i) {
+		if (_skyline[i].y == _skyline[i + 1].y) {
+			_skyline[i].w += _skyline[i + 1].w;
+			_skyline.erase(_skyline.begin() + i + 1);
+			--i;
+		}
+	}
+	_usedArea += w * h;
+}
+
+VyTextureAtlas::VyTextureAtlas(SDL_Renderer* renderer, int pageSize, int padding)
+	: _renderer(renderer), _pageSize(pageSize), _padding(padding), _pages() {}
+
+VyTextureAtlas::~VyTextureAtlas() {
+	Clear();
+}
+
+void VyTextureAtlas::Clear() {
+	for (int i = 0; i < _pages.size(); ++i) {
+		SDL_DestroyTexture(_pages[i].texture);
+	}
+	_pages.clear();
+}
+
+VyEngine::ErrorCode VyTextureAtlas::AddPage(int width, int height) {
+	SDL_Texture* texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
+	if (texture == NULL) {
+		VyEngine::GetInstance()->ErrorMessage = string_format("Unable to create %dx%d atlas page! SDL Error: %s\n", width, height, SDL_GetError());
+		return VyEngine::ErrorCode::Failure;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+	// static textures start undefined, and the padding between sprites must be transparent
+	std::vector<Uint32> clear((size_t)width * height, 0);
+	SDL_UpdateTexture(texture, NULL, clear.data(), width * (int)sizeof(Uint32));
+	_pages.push_back(Page(width, height));
+	_pages.back().texture = texture;
+	return VyEngine::ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyTextureAtlas::Add(SDL_Surface* surface, VyAtlasSprite& out_sprite) {
+	if (surface == NULL) {
+		VyEngine::GetInstance()->ErrorMessage = "Unable to add NULL surface to atlas\n";
+		return VyEngine::ErrorCode::InputError;
+	}
+	int paddedW = surface->w + _padding * 2, paddedH = surface->h + _padding * 2;
+	Coord position;
+	int page = -1;
+	for (int i = 0; i < _pages.size(); ++i) {
+		if (_pages[i].packer.Pack(paddedW, paddedH, position)) {
+			page = i;
+			break;
+		}
+	}
+	if (page < 0) {
+		VyEngine::ErrorCode err = AddPage(std::max(_pageSize, paddedW), std::max(_pageSize, paddedH));
+		if (err != VyEngine::ErrorCode::Success) { return err; }
+		page = (int)_pages.size() - 1;
+		_pages[page].packer.Pack(paddedW, paddedH, position);
+	}
+	SDL_Surface* converted = surface;
+	if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+		converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+		if (converted == NULL) {
+			VyEngine::GetInstance()->ErrorMessage = string_format("Unable to convert surface for atlas! SDL Error: %s\n", SDL_GetError());
+			return VyEngine::ErrorCode::UnsupportedFormat;
+		}
+	}
+	const Page& target = _pages[page];
+	Rect source(position.x + _padding, position.y + _padding, surface->w, surface->h);
+	if (SDL_MUSTLOCK(converted)) { SDL_LockSurface(converted); }
+	int result = SDL_UpdateTexture(target.texture, &source, converted->pixels, converted->pitch);
+	if (SDL_MUSTLOCK(converted)) { SDL_UnlockSurface(converted); }
+	if (converted != surface) {
+		SDL_FreeSurface(converted);
+	}
+	if (result != 0) {
+		VyEngine::GetInstance()->ErrorMessage = string_format("Unable to upload sprite to atlas! SDL Error: %s\n", SDL_GetError());
+		return VyEngine::ErrorCode::Failure;
+	}
+	out_sprite.texture = target.texture;
+	out_sprite.source = source;
+	out_sprite.page = page;
+	out_sprite.uvMin = { (float)source.x / target.width, (float)source.y / target.height };
+	out_sprite.uvMax = { (float)(source.x + source.w) / target.width, (float)(source.y + source.h) / target.height };
+	return VyEngine::ErrorCode::Success;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "vyengine.h"
+
+/// <summary>
+/// skyline bottom-left rectangle packer: keeps the top edge of everything packed so far as a list of horizontal segments,
+/// and puts each new rect where its top ends up lowest
+/// </summary>
+class VySkylinePacker {
+private:
+	struct Segment {
+		int x, y, w;
+	};
+	int _width, _height;
+	int _usedArea;
+	std::vector<Segment> _skyline;
+public:
+	VySkylinePacker(int width, int height);
+	/// <returns>false if there is no room for a w x h rect</returns>
+	bool Pack(int w, int h, Coord& out_position);
+	void Reset();
+	/// <returns>fraction of the area packed, from 0 to 1</returns>
+	float GetOccupancy() const;
+private:
+	/// <returns>the y a w x h rect would rest at if its left edge is at segment index, or -1 if it doesn't fit</returns>
+	int Fit(int index, int w, int h) const;
+	void Place(int index, int x, int y, int w, int h);
+};
+
+/// <summary>
+/// handle to a sub-rect of an atlas page. stays valid until the atlas is cleared or destroyed
+/// </summary>
+class VyAtlasSprite {
+public:
+	SDL_Texture* texture;
+	/// <summary>pixels of the sprite inside the page texture</summary>
+	Rect source;
+	/// <summary>normalized texture coordinates of source, for SDL_RenderGeometry</summary>
+	SDL_FPoint uvMin, uvMax;
+	int page;
+
+	VyAtlasSprite() : texture(NULL), source(), uvMin({ 0, 0 }), uvMax({ 0, 0 }), page(-1) {}
+	bool IsValid() const { return texture != NULL; }
+	Coord GetSize() const { return Coord(source.w, source.h); }
+	/// <summary>
+	/// draws on its own with SDL_RenderCopy. prefer <see cref="VySpriteBatch::Draw"/> when drawing many
+	/// </summary>
+	void Draw(SDL_Renderer* g, const Rect& dest) const { SDL_RenderCopy(g, texture, &source, &dest); }
+};
+
+/// <summary>
+/// packs surfaces into a few large ARGB8888 textures, so sprites can share a texture and be drawn in one batch.
+/// images bigger than a page get a page of their own
+/// </summary>
+class VyTextureAtlas {
+private:
+	struct Page {
+		SDL_Texture* texture;
+		VySkylinePacker packer;
+		int width, height;
+		Page(int width, int height) : texture(NULL), packer(width, height), width(width), height(height) {}
+	};
+	SDL_Renderer* _renderer;
+	int _pageSize;
+	int _padding;
+	std::vector<Page> _pages;
+public:
+	/// <param name="padding">transparent pixels kept around each sprite, so linear filtering doesn't pick up neighbors</param>
+	VyTextureAtlas(SDL_Renderer* renderer, int pageSize = 1024, int padding = 1);
+	~VyTextureAtlas();
+	/// <summary>
+	/// copies the surface into a page. the surface still belongs to the caller
+	/// </summary>
+	VyEngine::ErrorCode Add(SDL_Surface* surface, VyAtlasSprite& out_sprite);
+	int GetPageCount() const { return (int)_pages.size(); }
+	SDL_Texture* GetPageTexture(int page) const { return _pages[page].texture; }
+	float GetOccupancy(int page) const { return _pages[page].packer.GetOccupancy(); }
+	/// <summary>
+	/// destroys every page, invalidating all sprites
+	/// </summary>
+	void Clear();
+private:
+	VyEngine::ErrorCode AddPage(int width, int height);
+};
@@ -0,0 +1,78 @@
+#include "vycamera.h"
+#include <math.h>
+
+VyCamera::VyCamera(int width, int height) : _position(), _zoom(1), _screenSize(width, height), _version(0), _culled(0), _drawn(0), _drawOffset() {}
+
+void VyCamera::SetPosition(const Coord& position) {
+	if (position == _position) { return; }
+	_position = position;
+	++_version;
+}
+
+void VyCamera::SetZoom(float zoom) {
+	if (zoom < 1 / 64.0f) { zoom = 1 / 64.0f; }
+	if (zoom > 64) { zoom = 64; }
+	if (zoom == _zoom) { return; }
+	_zoom = zoom;
+	++_version;
+}
+
+void VyCamera::SetScreenSize(int width, int height) {
+	_screenSize = Coord(width, height);
+	++_version;
+}
+
+Rect VyCamera::GetView() const {
+	SDL_Rect screen = { 0, 0, _screenSize.x, _screenSize.y };
+	return Rect(ScreenToWorld(screen));
+}
+
+Coord VyCamera::WorldToScreen(const Coord& world) const {
+	return Coord((int)floorf((world.x - _position.x) * _zoom), (int)floorf((world.y - _position.y) * _zoom));
+}
+
+Coord VyCamera::ScreenToWorld(const Coord& screen) const {
+	return Coord(_position.x + (int)floorf(screen.x / _zoom), _position.y + (int)floorf(screen.y / _zoom));
+}
+
+SDL_Rect VyCamera::WorldToScreen(const SDL_Rect& world) const {
+	int minX = (int)floorf((world.x - _position.x) * _zoom), minY = (int)floorf((world.y - _position.y) * _zoom);
+	int maxX = (int)ceilf((world.x + world.w - _position.x) * _zoom), maxY = (int)ceilf((world.y + world.h - _position.y) * _zoom);
+	SDL_Rect screen = { minX, minY, maxX - minX, maxY - minY };
+	return screen;
+}
+
+SDL_Rect VyCamera::ScreenToWorld(const SDL_Rect& screen) const {
+	int minX = _position.x + (int)floorf(screen.x / _zoom), minY = _position.y + (int)floorf(screen.y / _zoom);
+	int maxX = _position.x + (int)ceilf((screen.x + screen.w) / _zoom), maxY = _position.y + (int)ceilf((screen.y + screen.h) / _zoom);
+	SDL_Rect world = { minX, minY, maxX - minX, maxY - minY };
+	return world;
+}
+
+bool VyCamera::IsVisible(const SDL_Rect& worldBounds) const {
+	Rect view = GetView();
+	return SDL_HasIntersection(&worldBounds, &view) == SDL_TRUE;
+}
+
+bool VyCamera::IsCulled(VyDrawable* drawable) {
+	SDL_Rect bounds;
+	if (drawable->GetDrawBounds(bounds) && !IsVisible(bounds)) {
+		++_culled;
+		return true;
+	}
+	++_drawn;
+	return false;
+}
+
+void VyCamera::Apply(SDL_Renderer* g) {
+	// world point p is drawn at p - position, which the scale puts on (p - position) * zoom
+	SDL_RenderSetScale(g, _zoom, _zoom);
+	SDL_RenderSetViewport(g, NULL);
+	_drawOffset = -_position;
+}
+
+void VyCamera::Reset(SDL_Renderer* g) {
+	SDL_RenderSetScale(g, 1, 1);
+	SDL_RenderSetViewport(g, NULL);
+	_drawOffset = Coord();
+}
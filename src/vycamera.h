@@ -0,0 +1,83 @@
+#pragma once
+#include <SDL.h>
+#include "coord.h"
+#include "rect.h"
+#include "sdleventprocessor.h"
+
+/// <summary>
+/// the part of the world on screen: Position is the world point at the top left of the screen, and Zoom is screen pixels per world unit.
+/// drawables report <see cref="VyDrawable::GetDrawBounds"/> in world coordinates. <see cref="VyCamera::Apply"/> scales the renderer's output,
+/// and the engine's batches and render queue offset what is added to them by <see cref="VyCamera::GetDrawOffset"/>.
+/// <see cref="VyDrawable::Draw"/> is passed the offset too, for drawables calling the renderer directly.
+/// <see cref="VyCamera::IsCulled"/> skips drawables whose bounds miss the view before they are drawn
+/// </summary>
+class VyCamera {
+private:
+	Coord _position;
+	float _zoom;
+	Coord _screenSize;
+	/// <summary>changed by anything that moves the view, so cached screen state knows to start over</summary>
+	Uint32 _version;
+	int _culled;
+	int _drawn;
+	/// <summary>-_position while applied, nothing otherwise</summary>
+	Coord _drawOffset;
+public:
+	VyCamera(int width, int height);
+	const Coord& GetPosition() const { return _position; }
+	void SetPosition(const Coord& position);
+	void Move(const Coord& delta) { SetPosition(_position + delta); }
+	float GetZoom() const { return _zoom; }
+	/// <summary>
+	/// zoom about the top left corner. at most 1/64 or 64
+	/// </summary>
+	void SetZoom(float zoom);
+	const Coord& GetScreenSize() const { return _screenSize; }
+	void SetScreenSize(int width, int height);
+	Uint32 GetVersion() const { return _version; }
+	/// <summary>
+	/// world and screen are the same coordinates
+	/// </summary>
+	bool IsIdentity() const { return _position.x == 0 && _position.y == 0 && _zoom == 1; }
+	/// <summary>
+	/// the world area on screen
+	/// </summary>
+	Rect GetView() const;
+	Coord WorldToScreen(const Coord& world) const;
+	Coord ScreenToWorld(const Coord& screen) const;
+	/// <summary>
+	/// rounded outward, so the result covers every pixel the area touches
+	/// </summary>
+	SDL_Rect WorldToScreen(const SDL_Rect& world) const;
+	SDL_Rect ScreenToWorld(const SDL_Rect& screen) const;
+	bool IsVisible(const SDL_Rect& worldBounds) const;
+	/// <summary>
+	/// counted as culled or drawn, for the stats
+	/// </summary>
+	/// <returns>true if the drawable reports bounds, and they miss the view. drawables without bounds are always drawn</returns>
+	bool IsCulled(VyDrawable* drawable);
+	/// <summary>
+	/// sets the renderer's scale, and the draw offset, so world coordinates plus the offset land where this camera shows them.
+	/// the pan is an offset rather than a viewport, since some backends (direct3d) can't take a viewport with a negative origin
+	/// </summary>
+	void Apply(SDL_Renderer* g);
+	/// <summary>
+	/// back to screen coordinates: no scale, no offset
+	/// </summary>
+	void Reset(SDL_Renderer* g);
+	/// <summary>
+	/// added to world coordinates to draw them while applied, before the renderer's scale. nothing while not applied
+	/// </summary>
+	const Coord& GetDrawOffset() const { return _drawOffset; }
+	Coord ToDraw(const Coord& world) const { return world + _drawOffset; }
+	SDL_Rect ToDraw(const SDL_Rect& world) const {
+		SDL_Rect draw = { world.x + _drawOffset.x, world.y + _drawOffset.y, world.w, world.h };
+		return draw;
+	}
+	/// <summary>
+	/// drawables skipped by <see cref="VyCamera::IsCulled"/> since <see cref="VyCamera::ResetStats"/>
+	/// </summary>
+	int GetCulledCount() const { return _culled; }
+	int GetDrawnCount() const { return _drawn; }
+	void ResetStats() { _culled = 0; _drawn = 0; }
+};
@@ -0,0 +1,72 @@
+#include "vycirclecache.h"
+#include <algorithm>
+#include "vyspritebatch.h"
+#include "sdlhelper.h"
+#include "stringstuff.h"
+
+/// <summary>
+/// lets VyFillCircle and VyDrawCircle draw into a surface
+/// </summary>
+class SurfaceCircleTarget {
+public:
+	SDL_Surface* surface;
+	Uint32 color;
+	SurfaceCircleTarget(SDL_Surface* surface, Uint32 color) : surface(surface), color(color) {}
+	void FillSpan(int x0, int x1, int y) {
+		if (x0 > x1) { std::swap(x0, x1); }
+		SDL_Rect rect = { x0, y, x1 - x0 + 1, 1 };
+		SDL_FillRect(surface, &rect, color);
+	}
+	void FillColumn(int x, int y0, int y1) {
+		if (y0 > y1) { std::swap(y0, y1); }
+		SDL_Rect rect = { x, y0, 1, y1 - y0 + 1 };
+		SDL_FillRect(surface, &rect, color);
+	}
+	void Point(int x, int y) {
+		SDL_Rect rect = { x, y, 1, 1 };
+		SDL_FillRect(surface, &rect, color);
+	}
+};
+
+VyCircleCache::VyCircleCache(VyTextureAtlas* atlas) : _atlas(atlas), _sprites() {}
+
+VyEngine::ErrorCode VyCircleCache::Get(float radius, bool filled, VyAtlasSprite& out_sprite) {
+	int diameter = (int)(radius * 2);
+	if (diameter < 0) { diameter = 0; }
+	int key = diameter * 2 + (filled ? 1 : 0);
+	auto found = _sprites.find(key);
+	if (found != _sprites.end()) {
+		out_sprite = found->second;
+		return VyEngine::ErrorCode::Success;
+	}
+	// the profile reaches diameter / 2 - 1 pixels from the center, so this leaves at least one transparent pixel on each side
+	int center = GetCenter(radius);
+	int size = center * 2 + 1;
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (surface == NULL) {
+		VyEngine::GetInstance()->ErrorMessage = string_format("Unable to create %dx%d circle surface! SDL Error: %s\n", size, size, SDL_GetError());
+		return VyEngine::ErrorCode::Failure;
+	}
+	SurfaceCircleTarget target(surface, SDL_MapRGBA(surface->format, 0xFF, 0xFF, 0xFF, 0xFF));
+	if (filled) {
+		VyFillCircle(target, (float)center, (float)center, radius);
+	} else {
+		VyDrawCircle(target, (float)center, (float)center, radius);
+	}
+	VyAtlasSprite sprite;
+	VyEngine::ErrorCode err = _atlas->Add(surface, sprite);
+	SDL_FreeSurface(surface);
+	if (err != VyEngine::ErrorCode::Success) { return err; }
+	_sprites[key] = sprite;
+	out_sprite = sprite;
+	return VyEngine::ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyCircleCache::Draw(VySpriteBatch& batch, float cx, float cy, float radius, bool filled, SDL_Color color) {
+	VyAtlasSprite sprite;
+	VyEngine::ErrorCode err = Get(radius, filled, sprite);
+	if (err != VyEngine::ErrorCode::Success) { return err; }
+	int center = GetCenter(radius);
+	batch.Draw(sprite, Rect((int)cx - center, (int)cy - center, sprite.source.w, sprite.source.h), color);
+	return VyEngine::ErrorCode::Success;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <SDL.h>
+#include <unordered_map>
+#include "vyatlas.h"
+
+class VySpriteBatch;
+
+/// <summary>
+/// filled and outlined circles rasterized once per size, white, into a <see cref="VyTextureAtlas"/>.
+/// each circle is then one tinted quad in a <see cref="VySpriteBatch"/>, so many circles of a few sizes draw with one SDL_RenderGeometry call
+/// </summary>
+class VyCircleCache {
+private:
+	VyTextureAtlas* _atlas;
+	/// <summary>keyed by diameter * 2, plus 1 when filled</summary>
+	std::unordered_map<int, VyAtlasSprite> _sprites;
+public:
+	VyCircleCache(VyTextureAtlas* atlas);
+	/// <summary>
+	/// the circle SDL_FillCircle (filled) or SDL_DrawCircle would draw at the center of the sprite, rasterizing it on first use
+	/// </summary>
+	VyEngine::ErrorCode Get(float radius, bool filled, VyAtlasSprite& out_sprite);
+	/// <summary>
+	/// the same pixels as SDL_FillCircle or SDL_DrawCircle in color, for integer centers
+	/// </summary>
+	VyEngine::ErrorCode Draw(VySpriteBatch& batch, float cx, float cy, float radius, bool filled, SDL_Color color);
+	/// <summary>
+	/// where the circle's center is in its sprite, the same for both axes
+	/// </summary>
+	static int GetCenter(float radius) { return (int)(radius * 2) / 2 + 1; }
+	int GetSpriteCount() const { return (int)_sprites.size(); }
+};
@@ -0,0 +1,70 @@
+#include "vycircleprofile.h"
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+/// <summary>
+/// the midpoint circle algorithm, starting at x = diameter / 2 - 1, which is (int)(radius - 1) for every radius of that diameter from 2 up.
+/// diameters 0 and 1 start at 0, a single pixel, as (int)(radius - 1) truncates to for any radius between 0 and 1
+/// </summary>
+/// <param name="out">where the x, y pairs go, or NULL to only count them</param>
+/// <returns>ints written</returns>
+static constexpr int RasterizeCircle(int diameter, int* out) {
+	int x = diameter / 2 - 1 > 0 ? diameter / 2 - 1 : 0, y = 0, tx = 1, ty = 1, error = (tx - diameter);
+	int count = 0;
+	while (x >= y) {
+		if (out != nullptr) {
+			out[count + 0] = x;
+			out[count + 1] = y;
+		}
+		count += 2;
+		if (error <= 0) { ++y; error += ty; ty += 2; }
+		if (error > 0) { --x; tx += 2; error += (tx - diameter); }
+	}
+	return count;
+}
+
+static constexpr int PrecomputedValueCount() {
+	int count = 0;
+	for (int diameter = 0; diameter < VyCircleProfile::PrecomputedDiameters; ++diameter) {
+		count += RasterizeCircle(diameter, nullptr);
+	}
+	return count;
+}
+
+/// <summary>
+/// every precomputed profile back to back, and where each one starts
+/// </summary>
+struct PrecomputedProfiles {
+	int offsets[VyCircleProfile::PrecomputedDiameters + 1];
+	int values[PrecomputedValueCount()];
+	constexpr PrecomputedProfiles() : offsets(), values() {
+		int offset = 0;
+		for (int diameter = 0; diameter < VyCircleProfile::PrecomputedDiameters; ++diameter) {
+			offsets[diameter] = offset;
+			offset += RasterizeCircle(diameter, values + offset);
+		}
+		offsets[VyCircleProfile::PrecomputedDiameters] = offset;
+	}
+};
+
+static constexpr PrecomputedProfiles PRECOMPUTED_PROFILES;
+
+VyCircleProfile VyCircleProfile::GetByDiameter(int diameter) {
+	if (diameter < 0) { diameter = 0; }
+	if (diameter < PrecomputedDiameters) {
+		int offset = PRECOMPUTED_PROFILES.offsets[diameter];
+		return VyCircleProfile(PRECOMPUTED_PROFILES.values + offset, PRECOMPUTED_PROFILES.offsets[diameter + 1] - offset);
+	}
+	// each profile has its own allocation, so values handed out stay valid as the map grows
+	static std::mutex computedMutex;
+	static std::unordered_map<int, std::unique_ptr<std::vector<int>>> computed;
+	std::lock_guard<std::mutex> lock(computedMutex);
+	std::unique_ptr<std::vector<int>>& profile = computed[diameter];
+	if (profile == nullptr) {
+		profile.reset(new std::vector<int>(RasterizeCircle(diameter, nullptr)));
+		RasterizeCircle(diameter, profile->data());
+	}
+	return VyCircleProfile(profile->data(), (int)profile->size());
+}
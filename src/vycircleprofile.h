@@ -0,0 +1,27 @@
+#pragma once
+
+/// <summary>
+/// the midpoint rasterization of one circle size: x, y pairs for one octant, x counting down from the radius as y counts up from 0.
+/// profiles are computed once per diameter and never change, so they can be read from any thread
+/// </summary>
+class VyCircleProfile {
+public:
+	/// <summary>x, y pairs</summary>
+	const int* values;
+	/// <summary>ints in values, two per pair. 0 for circles too small to draw</summary>
+	int count;
+	VyCircleProfile() : values(0), count(0) {}
+	VyCircleProfile(const int* values, int count) : values(values), count(count) {}
+	bool IsEmpty() const { return count == 0; }
+	/// <summary>y of the last pair, where the middle band ends and the top and bottom caps start</summary>
+	int GetLastY() const { return values[count - 1]; }
+	/// <summary>
+	/// diameters below this come from a table built at compile time. bigger ones are computed on first use, under a lock
+	/// </summary>
+	static const int PrecomputedDiameters = 129;
+	/// <summary>
+	/// the profile of the circle drawn by SDL_DrawCircle and SDL_FillCircle: only (int)(radius * 2) matters, and a radius of 0 or less draws nothing
+	/// </summary>
+	static VyCircleProfile Get(float radius) { return radius > 0 ? GetByDiameter((int)(radius * 2)) : VyCircleProfile(); }
+	static VyCircleProfile GetByDiameter(int diameter);
+};
@@ -0,0 +1,169 @@
+#pragma once
+#include <SDL.h>
+#include <tuple>
+#include <vector>
+#include <functional>
+#include "vyresourcetable.h"
+#include "sdleventprocessor.h"
+
+/// <summary>
+/// an entity in a <see cref="VyComponentStore"/>. stale after Destroy, like a texture handle after its last release
+/// </summary>
+typedef VyResourceHandle VyEntity;
+
+/// <summary>
+/// entities that all have the same plain-data components (one archetype), stored as one contiguous array per component type.
+/// a system reads just the arrays it needs, front to back, with no virtual calls and no pointer chasing,
+/// instead of visiting objects scattered across the heap like <see cref="VyComponentContainer"/>.
+/// each component type may appear once. destroying an entity moves the last one into its row, so rows are not stable: keep VyEntity handles
+/// </summary>
+template<typename... Components>
+class VyComponentStore {
+private:
+	std::tuple<std::vector<Components>...> _columns;
+	/// <summary>entity of each row</summary>
+	std::vector<Uint32> _rowEntity;
+	/// <summary>per entity index: its row while alive</summary>
+	std::vector<Uint32> _entityRow;
+	/// <summary>per entity index: 0 is never live, as in VyResourceHandle</summary>
+	std::vector<Uint32> _generations;
+	std::vector<Uint32> _freeEntities;
+public:
+	/// <summary>rows per call of a batch system, small enough that the arrays of one batch stay in L1/L2 together</summary>
+	static const int DefaultBatchSize = 1024;
+
+	void Reserve(int count) {
+		int expand[] = { 0, (std::get<std::vector<Components>>(_columns).reserve(count), 0)... };
+		(void)expand;
+		_rowEntity.reserve(count);
+		_entityRow.reserve(count);
+		_generations.reserve(count);
+	}
+
+	VyEntity Create(const Components&... values) {
+		Uint32 index;
+		if (!_freeEntities.empty()) {
+			index = _freeEntities.back();
+			_freeEntities.pop_back();
+		} else {
+			index = (Uint32)_generations.size();
+			_generations.push_back(0);
+			_entityRow.push_back(0);
+		}
+		Uint32 row = (Uint32)_rowEntity.size();
+		int expand[] = { 0, (std::get<std::vector<Components>>(_columns).push_back(values), 0)... };
+		(void)expand;
+		_rowEntity.push_back(index);
+		_entityRow[index] = row;
+		Uint32& generation = _generations[index];
+		// skip 0 when wrapping, it means null
+		generation = generation + 1 == 0 ? 1 : generation + 1;
+		return VyEntity(index, generation);
+	}
+
+	bool IsAlive(VyEntity entity) const {
+		return entity.generation != 0 && entity.index < _generations.size() && _generations[entity.index] == entity.generation;
+	}
+
+	/// <summary>
+	/// O(1): the last row moves into the destroyed one. stale entities are ignored
+	/// </summary>
+	void Destroy(VyEntity entity) {
+		if (!IsAlive(entity)) { return; }
+		Uint32 row = _entityRow[entity.index];
+		Uint32 last = (Uint32)_rowEntity.size() - 1;
+		if (row != last) {
+			int expand[] = { 0, (MoveRow(std::get<std::vector<Components>>(_columns), last, row), 0)... };
+			(void)expand;
+			_rowEntity[row] = _rowEntity[last];
+			_entityRow[_rowEntity[row]] = row;
+		}
+		int expand[] = { 0, (std::get<std::vector<Components>>(_columns).pop_back(), 0)... };
+		(void)expand;
+		_rowEntity.pop_back();
+		Uint32& generation = _generations[entity.index];
+		generation = generation + 1 == 0 ? 1 : generation + 1;
+		_freeEntities.push_back(entity.index);
+	}
+
+	/// <returns>NULL for stale entities</returns>
+	template<typename T>
+	T* Get(VyEntity entity) {
+		if (!IsAlive(entity)) { return NULL; }
+		return &std::get<std::vector<T>>(_columns)[_entityRow[entity.index]];
+	}
+
+	/// <summary>
+	/// every entity's T, in row order. invalidated by Create and Destroy
+	/// </summary>
+	template<typename T>
+	T* GetColumn() { return std::get<std::vector<T>>(_columns).data(); }
+
+	VyEntity GetEntity(int row) const {
+		Uint32 index = _rowEntity[row];
+		return VyEntity(index, _generations[index]);
+	}
+
+	int GetCount() const { return (int)_rowEntity.size(); }
+
+	/// <summary>
+	/// calls system(count, Used*...) with consecutive slices of the Used columns, at most batchSize rows each.
+	/// the system's inner loop runs over plain arrays, which the compiler can vectorize.
+	/// don't create or destroy entities of this store from inside the system
+	/// </summary>
+	template<typename... Used, typename System>
+	void ForEachBatch(System&& system, int batchSize = DefaultBatchSize) {
+		int count = GetCount();
+		for (int start = 0; start < count; start += batchSize) {
+			int n = count - start < batchSize ? count - start : batchSize;
+			system(n, (GetColumn<Used>() + start)...);
+		}
+	}
+
+	/// <summary>
+	/// calls system(Used&...) for every entity, in row order
+	/// </summary>
+	template<typename... Used, typename System>
+	void ForEach(System&& system) {
+		ForEachBatch<Used...>([&system](int n, Used*... columns) {
+			for (int i = 0; i < n; ++i) {
+				system(columns[i]...);
+			}
+		});
+	}
+
+	/// <summary>
+	/// destroys every entity. generations are kept, so entities from before stay stale when their indices are reused
+	/// </summary>
+	void Clear() {
+		for (Uint32 index : _rowEntity) {
+			Uint32& generation = _generations[index];
+			generation = generation + 1 == 0 ? 1 : generation + 1;
+			_freeEntities.push_back(index);
+		}
+		int expand[] = { 0, (std::get<std::vector<Components>>(_columns).clear(), 0)... };
+		(void)expand;
+		_rowEntity.clear();
+	}
+private:
+	template<typename T>
+	static void MoveRow(std::vector<T>& column, Uint32 from, Uint32 to) { column[to] = std::move(column[from]); }
+};
+
+/// <summary>
+/// a batch system over some columns of a store, registered with <see cref="VyEngine::RegisterUpdatable"/> like any other updatable:
+/// one virtual call per frame instead of one per entity
+/// </summary>
+template<typename Store, typename... Used>
+class VyComponentSystem : public VyUpdatable {
+private:
+	Store& _store;
+	std::function<void(int count, Used*... columns)> _system;
+	int _batchSize;
+public:
+	VyComponentSystem(Store& store, std::function<void(int count, Used*... columns)> system, int batchSize = Store::DefaultBatchSize)
+		: _store(store), _system(system), _batchSize(batchSize) {}
+	virtual void Update() {
+		_store.template ForEachBatch<Used...>(_system, _batchSize);
+	}
+};
@@ -0,0 +1,61 @@
+#include "vydamage.h"
+
+VyDamageRegion::VyDamageRegion(int width, int height, int maxRects) : _width(width), _height(height), _rects(), _maxRects(maxRects) {}
+
+void VyDamageRegion::SetSize(int width, int height) {
+	_width = width;
+	_height = height;
+	AddAll();
+}
+
+bool VyDamageRegion::ShouldMerge(const SDL_Rect& a, const SDL_Rect& b) {
+	if (SDL_HasIntersection(&a, &b)) { return true; }
+	SDL_Rect both;
+	SDL_UnionRect(&a, &b, &both);
+	// neighbors (a row of buttons) merge, far apart rects don't
+	return both.w * both.h <= (a.w * a.h + b.w * b.h) * 5 / 4;
+}
+
+void VyDamageRegion::Add(const SDL_Rect& rect) {
+	SDL_Rect screen = { 0, 0, _width, _height };
+	SDL_Rect added;
+	if (!SDL_IntersectRect(&rect, &screen, &added)) { return; }
+	// a merge grows the rect, which can make it overlap ones it didn't before, so keep merging until nothing changes
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		for (int i = 0; i < _rects.size(); ++i) {
+			if (ShouldMerge(added, _rects[i])) {
+				SDL_UnionRect(&added, &_rects[i], &added);
+				_rects[i] = _rects.back();
+				_rects.pop_back();
+				merged = true;
+				break;
+			}
+		}
+	}
+	_rects.push_back(added);
+	if (_rects.size() > _maxRects) {
+		SDL_Rect bounds = _rects[0];
+		for (int i = 1; i < _rects.size(); ++i) {
+			SDL_UnionRect(&bounds, &_rects[i], &bounds);
+		}
+		_rects.clear();
+		_rects.push_back(bounds);
+	}
+}
+
+void VyDamageRegion::AddAll() {
+	_rects.clear();
+	if (_width > 0 && _height > 0) {
+		_rects.push_back(Rect(0, 0, _width, _height));
+	}
+}
+
+int VyDamageRegion::GetArea() const {
+	int area = 0;
+	for (int i = 0; i < _rects.size(); ++i) {
+		area += _rects[i].w * _rects[i].h;
+	}
+	return area;
+}
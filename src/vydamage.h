@@ -0,0 +1,33 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "rect.h"
+
+/// <summary>
+/// the parts of the screen that changed since the last present, as a few non-overlapping rects.
+/// rects that overlap, or are close enough that redrawing the gap costs little, merge into their bounding box
+/// </summary>
+class VyDamageRegion {
+private:
+	int _width, _height;
+	std::vector<Rect> _rects;
+	/// <summary>past this many rects everything collapses into one bounding box: that many clip passes cost more than the overdraw</summary>
+	int _maxRects;
+public:
+	VyDamageRegion(int width, int height, int maxRects = 16);
+	void SetSize(int width, int height);
+	/// <summary>
+	/// clipped to the screen. empty rects are ignored
+	/// </summary>
+	void Add(const SDL_Rect& rect);
+	void AddAll();
+	bool IsEmpty() const { return _rects.empty(); }
+	const std::vector<Rect>& GetRects() const { return _rects; }
+	int GetArea() const;
+	void Clear() { _rects.clear(); }
+private:
+	/// <summary>
+	/// whether redrawing the bounding box of a and b is not much more than redrawing both
+	/// </summary>
+	static bool ShouldMerge(const SDL_Rect& a, const SDL_Rect& b);
+};
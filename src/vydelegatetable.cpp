@@ -0,0 +1,125 @@
+#include "vydelegatetable.h"
+
+VyDelegateTable::VyDelegateTable(Kind kind) : _kind(kind), _overflow() {
+	_slots.resize(kind == Kind::Keycode ? KeycodeSlots : MouseButtonSlots);
+}
+
+int VyDelegateTable::GetSlotIndex(int code) const {
+	switch (_kind) {
+	case Kind::Keycode:
+		if (code >= 0 && code < 256) {
+			return code;
+		}
+		if ((code & SDLK_SCANCODE_MASK) != 0) {
+			int scancode = code & ~SDLK_SCANCODE_MASK;
+			if (scancode >= 0 && scancode < SDL_NUM_SCANCODES) {
+				return 256 + scancode;
+			}
+		}
+		break;
+	case Kind::MouseButton:
+		if (code >= 0 && code < MouseButtonSlots) {
+			return code;
+		}
+		break;
+	}
+	auto found = _overflow.find(code);
+	return found != _overflow.end() ? found->second : -1;
+}
+
+int VyDelegateTable::GetOrAddSlotIndex(int code) {
+	int index = GetSlotIndex(code);
+	if (index < 0) {
+		index = (int)_slots.size();
+		_slots.emplace_back();
+		_overflow[code] = index;
+	}
+	return index;
+}
+
+VyDelegateTable::Binding& VyDelegateTable::GetBinding(Slot& slot, int index) {
+	int bindingCount = (int)slot.bindings.size();
+	return index < bindingCount ? slot.bindings[index] : slot.pending[index - bindingCount];
+}
+
+void VyDelegateTable::Register(int code, size_t owner, Delegate delegate) {
+	Slot& slot = _slots[GetOrAddSlotIndex(code)];
+	auto found = slot.owners.find(owner);
+	if (slot.dispatching == 0) {
+		if (found != slot.owners.end()) {
+			slot.bindings[found->second].delegate = std::move(delegate);
+			return;
+		}
+		slot.owners[owner] = (int)slot.bindings.size();
+		slot.bindings.push_back({ owner, std::move(delegate), true });
+		return;
+	}
+	if (found != slot.owners.end()) {
+		// the old delegate may be the one running right now, so it can't be replaced in place
+		GetBinding(slot, found->second).alive = false;
+		++slot.dead;
+	}
+	slot.owners[owner] = (int)(slot.bindings.size() + slot.pending.size());
+	slot.pending.push_back({ owner, std::move(delegate), true });
+}
+
+void VyDelegateTable::Unregister(int code, size_t owner) {
+	int index = GetSlotIndex(code);
+	if (index < 0) { return; }
+	Slot& slot = _slots[index];
+	auto found = slot.owners.find(owner);
+	if (found == slot.owners.end()) { return; }
+	GetBinding(slot, found->second).alive = false;
+	slot.owners.erase(found);
+	++slot.dead;
+	if (slot.dispatching == 0 && slot.dead * 2 >= (int)slot.bindings.size()) {
+		Compact(slot);
+	}
+}
+
+void VyDelegateTable::Dispatch(int code, const SDL_Event& e) {
+	int index = GetSlotIndex(code);
+	if (index < 0) { return; }
+	Slot& slot = _slots[index];
+	const int count = (int)slot.bindings.size();
+	if (count == 0) { return; }
+	++slot.dispatching;
+	for (int i = 0; i < count; ++i) {
+		Binding& binding = slot.bindings[i];
+		if (binding.alive) {
+			binding.delegate(e);
+		}
+	}
+	if (--slot.dispatching > 0) { return; }
+	if (!slot.pending.empty()) {
+		for (Binding& binding : slot.pending) {
+			slot.bindings.push_back(std::move(binding));
+		}
+		slot.pending.clear();
+	}
+	if (slot.dead > 0) {
+		Compact(slot);
+	}
+}
+
+int VyDelegateTable::GetCount(int code) const {
+	int index = GetSlotIndex(code);
+	return index < 0 ? 0 : (int)_slots[index].owners.size();
+}
+
+/// <summary>
+/// drops tombstones, keeping registration order, and re-indexes owners
+/// </summary>
+void VyDelegateTable::Compact(Slot& slot) {
+	int write = 0;
+	for (int read = 0; read < (int)slot.bindings.size(); ++read) {
+		if (!slot.bindings[read].alive) { continue; }
+		if (write != read) {
+			slot.bindings[write] = std::move(slot.bindings[read]);
+			slot.owners[slot.bindings[write].owner] = write;
+		}
+		++write;
+	}
+	slot.bindings.erase(slot.bindings.begin() + write, slot.bindings.end());
+	slot.dead = 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include "vyinlinefunction.h"
+
+/// <summary>
+/// input delegates bound per key or mouse button, indexed densely so dispatch is an array lookup and a contiguous walk.
+/// each owner has at most one delegate per code; registering again replaces it. delegates run in registration order.
+/// registering or unregistering from inside a delegate is safe: removals are tombstoned until the dispatch finishes.
+/// </summary>
+class VyDelegateTable {
+public:
+	typedef VyInlineFunction<void(const SDL_Event&)> Delegate;
+	enum class Kind { Keycode, MouseButton };
+	/// <summary>
+	/// keycodes below 256 index directly, SDLK_SCANCODE_MASK keycodes follow them. anything else goes to an overflow map
+	/// </summary>
+	static const int KeycodeSlots = 256 + SDL_NUM_SCANCODES;
+	static const int MouseButtonSlots = 256;
+private:
+	struct Binding {
+		size_t owner;
+		Delegate delegate;
+		bool alive;
+	};
+	struct Slot {
+		std::vector<Binding> bindings;
+		/// <summary>registered during a dispatch, appended to bindings once it finishes so running delegates never move</summary>
+		std::vector<Binding> pending;
+		/// <summary>owner to index in bindings, or bindings.size() + index in pending</summary>
+		std::unordered_map<size_t, int> owners;
+		int dead;
+		int dispatching;
+		Slot() : dead(0), dispatching(0) {}
+	};
+	Kind _kind;
+	/// <summary>a deque, so adding an overflow slot from inside a delegate never moves the slot, or the delegate, that is running</summary>
+	std::deque<Slot> _slots;
+	std::unordered_map<int, int> _overflow;
+public:
+	VyDelegateTable(Kind kind);
+	void Register(int code, size_t owner, Delegate delegate);
+	void Unregister(int code, size_t owner);
+	/// <summary>
+	/// calls every delegate bound to code. delegates added during the dispatch wait for the next one
+	/// </summary>
+	void Dispatch(int code, const SDL_Event& e);
+	/// <returns>how many owners are bound to code</returns>
+	int GetCount(int code) const;
+private:
+	int GetSlotIndex(int code) const;
+	int GetOrAddSlotIndex(int code);
+	static Binding& GetBinding(Slot& slot, int index);
+	static void Compact(Slot& slot);
+};
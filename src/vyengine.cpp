@@ -4,9 +4,21 @@
 #include <cctype>
 #include <SDL_image.h>
 #include <algorithm>
+#include <typeinfo>
+#include <cmath>
 #include "helper.h"
-
-#define CLEAR_ARRAY(arr) memset(arr, 0, sizeof(arr))
+#include "vyprofiler.h"
+#include "vyatlas.h"
+#include "vyspritebatch.h"
+#include "vyglyphcache.h"
+#include "vyfontcache.h"
+#include "vyrenderqueue.h"
+#include "vyprimitivebatch.h"
+#include "vycirclecache.h"
+#include "vyframearena.h"
+#include "vyjobsystem.h"
+#include "vyinputrecording.h"
+#include "selectablerect.h"
 
 VyEngine * VyEngine::_instance = NULL;
 
@@ -17,28 +29,34 @@ void VyEngine::FailFast() {
 	}
 }
 
-VyEngine::VyEngine(int width, int height) : MouseClickState(0), _window(NULL), _screenSurface(NULL), _width(width), _height(height),
+VyEngine::VyEngine(int width, int height) : MouseClickState(0), WindowFlags(SDL_WINDOW_SHOWN), RendererFlags(SDL_RENDERER_ACCELERATED),
+FixedTimestep(1 / 60.0), TargetFrameTime(1 / 60.0), MaxCatchUpSteps(5), AssetUploadBudget(0.002), UseRenderQueue(false), UseDamageTracking(false), UseParallelUpdate(false), ParallelUpdateChunk(64), UseCulling(true), CoalesceMouseMotion(true), _interpolationAlpha(0), _frameWorkTime(0), _window(NULL), _screenSurface(NULL), _width(width), _height(height),
 _rendererKind(Renderer::None), _running(false), _initialized(false), _currentFont(NULL),
-_isPressedKeyMask(), _isMousePressed(), _isPressedKeyMaskScancode(),
-_managedSurfaces(), _fonts(), _eventProcessors(), _todo(NULL), _todoNow(NULL), _currentFontSize(0) {
+_keyBindDown(VyDelegateTable::Kind::Keycode), _keyBindUp(VyDelegateTable::Kind::Keycode),
+_mouseBindDown(VyDelegateTable::Kind::MouseButton), _mouseBindUp(VyDelegateTable::Kind::MouseButton),
+_input(), _inputNext(), _hitTest(), _hoveredTarget(NULL), _focusedTarget(NULL), _selection(NULL), _capturedTarget(), _hoverVersion(0), _hoverPosition(-1, -1),
+_damage(width, height), _camera(width, height), _drawnCameraVersion(0), _presentRects(), _managedSurfaces(), _atlas(NULL), _spriteBatch(NULL), _renderQueue(NULL), _primitiveBatch(NULL), _circleCache(NULL), _fontCache(new VyFontCache()), _frameArena(new VyFrameArena()), _assetLoader(NULL), _eventProcessors(), _processorDispatchDepth(0), _processorsRemoved(false), _jobs(NULL), _actions(), _recorder(NULL), _replay(NULL), _replayFrame(0), _replaySteps(1), _hasPendingMotion(false), _coalescedMotion(0), _currentFontId(-1) {
 	ErrorMessage = "";
 	if (_instance == NULL) {
 		_instance = this;
 	} else {
 		printf("duplicate VyEngine being created? already have at %016llux", (size_t)_instance);
 	}
-	CLEAR_ARRAY(_isPressedKeyMask);
-	CLEAR_ARRAY(_isPressedKeyMaskScancode);
-	CLEAR_ARRAY(_isMousePressed);
-	_todo = DelegateListPtr(new std::vector<DelegateNextFrame>());
-	_todoNow = DelegateListPtr(new std::vector<DelegateNextFrame>());
 }
 
 VyEngine::~VyEngine() {
 	Release();
+	delete _fontCache;
+	delete _frameArena;
+	delete _jobs;
+	delete _recorder;
+	delete _replay;
 }
 
 VyEngine::ErrorCode VyEngine::Release() {
+	// stop the workers before anything they could be decoding into goes away
+	delete _assetLoader;
+	_assetLoader = NULL;
 	for (int i = 0; i < _managedSurfaces.size(); ++i) {
 		SDL_Surface* loadedSurface = _managedSurfaces[i];
 		if (loadedSurface == NULL) {
@@ -47,22 +65,40 @@ VyEngine::ErrorCode VyEngine::Release() {
 		_managedSurfaces[i] = NULL;
 		SDL_FreeSurface(loadedSurface);
 	}
-	for (int i = 0; i < _managedTextures.size(); ++i) {
-		SDL_Texture* loadedTexture = (SDL_Texture*)_managedTextures[i];
-		if (loadedTexture == NULL) {
-			continue;
-		}
-		_managedTextures[i] = NULL;
-		SDL_DestroyTexture(loadedTexture);
+	_textures.Clear([](SDL_Texture* texture) { SDL_DestroyTexture(texture); });
+	_textureHandles.clear();
+	for (auto it = _glyphCaches.begin(); it != _glyphCaches.end(); ++it) {
+		delete it->second;
 	}
+	_glyphCaches.clear();
+	delete _circleCache;
+	_circleCache = NULL;
+	_fontCache->Clear();
+	_currentFont = NULL;
+	_currentFontId = -1;
+	delete _renderQueue;
+	_renderQueue = NULL;
+	delete _primitiveBatch;
+	_primitiveBatch = NULL;
+	delete _spriteBatch;
+	_spriteBatch = NULL;
+	delete _atlas;
+	_atlas = NULL;
 	switch (_rendererKind) {
+	case Renderer::SDL_Surface:
 	case Renderer::SDL_Renderer:
+	case Renderer::Offscreen:
 		if (_renderer != NULL) {
 			SDL_DestroyRenderer(_renderer);
 			_renderer = NULL;
 		}
 		break;
 	}
+	if (_rendererKind == Renderer::Offscreen && _screenSurface != NULL) {
+		// ours, unlike a window surface
+		SDL_FreeSurface(_screenSurface);
+		_screenSurface = NULL;
+	}
 	if (_window != NULL)
 	{
 		SDL_DestroyWindow(_window);
@@ -82,7 +118,8 @@ VyEngine::ErrorCode VyEngine::Init(std::string windowName, Renderer renderer)
 	}
 	_running = false;
 	_rendererKind = Renderer::None;
-	if (SDL_Init(SDL_INIT_VIDEO) < 0)
+	// offscreen needs no display, only the event queue for input and the engine's own events
+	if (SDL_Init(renderer == Renderer::Offscreen ? SDL_INIT_EVENTS : SDL_INIT_VIDEO) < 0)
 	{
 		ErrorMessage = string_format("SDL could not initialize! SDL_Error: %s", SDL_GetError());
 		return VyEngine::ErrorCode::InitializationFailure;
@@ -95,8 +132,10 @@ VyEngine::ErrorCode VyEngine::Init(std::string windowName, Renderer renderer)
 	}
 
 	_initialized = true;
-	_window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, _width, _height, SDL_WINDOW_SHOWN);
-	if (_window == NULL)
+	if (renderer != Renderer::Offscreen) {
+		_window = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, _width, _height, WindowFlags);
+	}
+	if (_window == NULL && renderer != Renderer::Offscreen)
 	{
 		ErrorMessage = string_format("Window could not be created! SDL_Error: %s", SDL_GetError());
 		return VyEngine::ErrorCode::WindowCreationFailure;
@@ -111,6 +150,9 @@ VyEngine::ErrorCode VyEngine::Init(std::string windowName, Renderer renderer)
 	case Renderer::SDL_Renderer:
 		errorCode = InitSDL_Renderer();
 		break;
+	case Renderer::Offscreen:
+		errorCode = InitOffscreen();
+		break;
 	default:
 		ErrorMessage = string_format("Renderer %d not implemented!", renderer);
 		errorCode = ErrorCode::NotImplemented;
@@ -143,102 +185,212 @@ SDL_Renderer* VyEngine::GetRenderer() { return this->_renderer; }
 
 TTF_Font* VyEngine::GetFont() { return this->_currentFont; }
 
-std::string VyEngine::GetFontName() { return this->_currentFontName; }
+std::string VyEngine::GetFontName() { return _currentFontId < 0 ? "" : _fontCache->GetName(_currentFontId); }
 
-std::string VyEngine::GetFontId() { return this->_currentFontId; }
+VyEngine::FontId VyEngine::GetFontId() { return this->_currentFontId; }
 
-int VyEngine::GetFontSize() { return this->_currentFontSize; }
+int VyEngine::GetFontSize() { return _currentFontId < 0 ? 0 : _fontCache->GetSize(_currentFontId); }
+
+VyEngine::FontId VyEngine::RegisterFont(std::string fontName, int size) {
+	return _fontCache->GetId(fontName, size);
+}
 
 VyEngine::ErrorCode VyEngine::SetFont(std::string fontName, int size) {
-	std::string savedName = string_format("%s%d", fontName.c_str(), size);
-	auto iter = _fonts.find(savedName);
-	if (iter == _fonts.end()) {
-		std::string path = string_format("font/%s.ttf", fontName.c_str());
-		TTF_Font* font = TTF_OpenFont(path.c_str(), size);
-		if (font == NULL) {
-			ErrorMessage = string_format("could not load %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
-			VyEngine::ErrorCode::MissingResource;
-		}
-		_fonts[savedName] = font;
-		_currentFont = font;
-	} else {
-		_currentFont = iter->second;
+	return SetFont(RegisterFont(fontName, size));
+}
+
+VyEngine::ErrorCode VyEngine::SetFont(FontId font) {
+	if (font == _currentFontId) {
+		return VyEngine::ErrorCode::Success;
+	}
+	TTF_Font* opened = NULL;
+	VyEngine::ErrorCode err = _fontCache->Open(font, opened);
+	if (err != VyEngine::ErrorCode::Success) {
+		return err;
+	}
+	// pin before unpinning the old one, so making room can't close the font just opened
+	_fontCache->Pin(font);
+	if (_currentFontId >= 0) {
+		_fontCache->Unpin(_currentFontId);
 	}
-	_currentFontId = savedName;
-	_currentFontName = fontName;
-	_currentFontSize = size;
-	printf("current font: %s\n", _currentFontId.c_str());
+	_currentFont = opened;
+	_currentFontId = font;
 	return VyEngine::ErrorCode::Success;
 }
 
+VyFontCache* VyEngine::GetFontCache() { return _fontCache; }
+
+VyFrameArena* VyEngine::GetFrameArena() { return _frameArena; }
+
 void VyEngine::ClearGraphics() {
 	switch (_rendererKind) {
 	case Renderer::SDL_Surface:
+		if (UseDamageTracking) {
+			// only the damage gets cleared, in Render
+			break;
+		}
 		SDL_FillRect(_screenSurface, NULL, SDL_MapRGBA(_screenSurface->format, 0xFF, 0xFF, 0xFF, 0x00));
 		break;
 	case Renderer::SDL_Renderer:
+	case Renderer::Offscreen:
 		SDL_RenderClear(_renderer);
 		break;
 	}
 }
 
 void VyEngine::Render() {
-	SDL_Renderer* g = GetRenderer();
-	for (int b = 0; b < _drawables.size(); ++b) {
-		_drawables[b]->Draw(g);
-	}
-	switch (_rendererKind) {
-	case Renderer::SDL_Surface:
-		SDL_UpdateWindowSurface(_window);
-		break;
-	case Renderer::SDL_Renderer:
-		SDL_RenderPresent(_renderer);
-		break;
+	{
+		VY_PROFILE_ZONE("VyEngine::Render");
+		SDL_Renderer* g = GetRenderer();
+		VY_PROFILE_COUNTER("drawables", (Sint64)_drawables.size());
+		// reset here rather than after, like the render queue's, so last frame's counts stay readable
+		_camera.ResetStats();
+		_camera.Apply(g);
+		SetDrawOffset(_camera.GetDrawOffset());
+		if (_rendererKind == Renderer::SDL_Surface && UseDamageTracking) {
+			RenderDamage(g);
+		} else if (UseRenderQueue && _renderQueue != NULL) {
+			// reset here rather than after, so the counts of the last frame stay readable until the next Render
+			_renderQueue->ResetStats();
+			for (int b = 0; b < _drawables.size(); ++b) {
+				if (UseCulling && _camera.IsCulled(_drawables[b])) { continue; }
+				VY_PROFILE_ZONE(typeid(*_drawables[b]).name());
+				// later drawables sort after earlier ones, as they would paint over them
+				_renderQueue->SetOrder((Uint32)b);
+				if (!_drawables[b]->Record(*_renderQueue)) {
+					// drawn directly, so everything recorded before it has to be on screen first
+					FlushRenderQueue();
+					_drawables[b]->Draw(g, _camera.GetDrawOffset());
+				}
+			}
+			FlushRenderQueue();
+			_renderQueue->SetOrder(0);
+			VY_PROFILE_COUNTER("queued commands", (Sint64)_renderQueue->GetCommandCount());
+			VY_PROFILE_COUNTER("queue draw calls", (Sint64)_renderQueue->GetDrawCalls());
+		} else {
+			for (int b = 0; b < _drawables.size(); ++b) {
+				if (UseCulling && _camera.IsCulled(_drawables[b])) { continue; }
+				VY_PROFILE_ZONE(typeid(*_drawables[b]).name());
+				_drawables[b]->Draw(g, _camera.GetDrawOffset());
+			}
+		}
+		VY_PROFILE_COUNTER("culled drawables", (Sint64)_camera.GetCulledCount());
+		VY_PROFILE_COUNTER("drawn drawables", (Sint64)_camera.GetDrawnCount());
+		FlushBatches();
+		if (_spriteBatch != NULL) {
+			VY_PROFILE_COUNTER("sprite batches", (Sint64)_spriteBatch->GetDrawCalls());
+			_spriteBatch->ResetStats();
+		}
+		if (_primitiveBatch != NULL) {
+			VY_PROFILE_COUNTER("primitive draw calls", (Sint64)_primitiveBatch->GetDrawCalls());
+			_primitiveBatch->ResetStats();
+		}
+		// back to screen coordinates, for whatever is drawn outside Render, like Run's onDraw
+		_camera.Reset(g);
+		SetDrawOffset(Coord());
+		VY_PROFILE_ZONE("VyEngine::Present");
+		switch (_rendererKind) {
+		case Renderer::SDL_Surface:
+			// the software renderer batches: everything has to reach the surface before it is shown
+			SDL_RenderFlush(_renderer);
+			if (!UseDamageTracking) {
+				SDL_UpdateWindowSurface(_window);
+			} else if (!_presentRects.empty()) {
+				SDL_UpdateWindowSurfaceRects(_window, _presentRects.data(), (int)_presentRects.size());
+				_presentRects.clear();
+			}
+			break;
+		case Renderer::SDL_Renderer:
+			SDL_RenderPresent(_renderer);
+			break;
+		case Renderer::Offscreen:
+			// nothing to present or wait for: the frame only has to reach the memory surface
+			SDL_RenderFlush(_renderer);
+			break;
+		}
 	}
+	ServicePhase(Phase::EndOfFrame);
+	VY_PROFILE_FRAME();
 }
 
-void VyEngine::ProcessDelegates(std::vector<VyEventProcessor*> eventProcessors, const SDL_Event& e) {
-	for (int i = 0; i < eventProcessors.size(); ++i) {
-		eventProcessors[i]->HandleEvent(e);
+void VyEngine::ProcessDelegates(const std::vector<VyEventProcessor*>& eventProcessors, const SDL_Event& e) {
+	VY_PROFILE_ZONE("VyEngine::ProcessDelegates(processors)");
+	VY_PROFILE_COUNTER("processor calls", (Sint64)eventProcessors.size());
+	// the list may grow while processors run; the ones added get the next event
+	const size_t count = eventProcessors.size();
+	for (size_t i = 0; i < count; ++i) {
+		if (eventProcessors[i] != NULL) {
+			eventProcessors[i]->HandleEvent(e);
+		}
 	}
 }
 
-void VyEngine::ProcessDelegates(EventDelegateListMap& delegates, int id, const SDL_Event& e) {
-	EventDelegateListMap::iterator found = delegates.find(id);
-	if (found != delegates.end()) {
-		ProcessDelegates(found->second, e);
-	}
+void VyEngine::ProcessDelegates(VyDelegateTable& delegates, int id, const SDL_Event& e) {
+	VY_PROFILE_ZONE("VyEngine::ProcessDelegates(table)");
+	VY_PROFILE_COUNTER("delegate calls", delegates.GetCount(id));
+	delegates.Dispatch(id, e);
 }
 
 void VyEngine::ProcessDelegates(VyEngine::EventDelegateKeyedList& delegates, const SDL_Event& e) {
+	VY_PROFILE_ZONE("VyEngine::ProcessDelegates(event list)");
+	VY_PROFILE_COUNTER("delegate calls", (Sint64)delegates.size());
 	for (auto it = delegates.begin(); it != delegates.end(); it++) {
 		it->second(e);
 	}
 }
 
 void VyEngine::ProcessDelegates(VyEngine::EventKeyedList& delegates){
+	VY_PROFILE_ZONE("VyEngine::ProcessDelegates(list)");
+	VY_PROFILE_COUNTER("delegate calls", (Sint64)delegates.size());
 	for (auto it = delegates.begin(); it != delegates.end(); it++) {
 		it->second();
 	}
 }
 
 void VyEngine::RegisterProcessor(VyEventProcessor* eventProcessor) {
-	_eventProcessors.push_back(eventProcessor);
+	Uint32 mask = eventProcessor->GetEventMask();
+	for (int c = 0; c < (int)VyEventProcessor::EventCategory::Count; ++c) {
+		if ((mask & VyEventProcessor::Mask((VyEventProcessor::EventCategory)c)) != 0) {
+			_eventProcessors[c].push_back(eventProcessor);
+		}
+	}
 }
 
 void VyEngine::UnregisterProcessor(VyEventProcessor* eventProcessor) {
-	auto found = std::find(_eventProcessors.begin(), _eventProcessors.end(), eventProcessor);
-	if (found == _eventProcessors.end()) { return; }
-	_eventProcessors.erase(found);
+	for (int c = 0; c < (int)VyEventProcessor::EventCategory::Count; ++c) {
+		std::vector<VyEventProcessor*>& processors = _eventProcessors[c];
+		auto found = std::find(processors.begin(), processors.end(), eventProcessor);
+		if (found == processors.end()) { continue; }
+		if (_processorDispatchDepth > 0) {
+			// erasing would shift the processors after it past the running loop
+			*found = NULL;
+			_processorsRemoved = true;
+		} else {
+			processors.erase(found);
+		}
+	}
+}
+
+void VyEngine::UpdateEventMask(VyEventProcessor* eventProcessor) {
+	UnregisterProcessor(eventProcessor);
+	RegisterProcessor(eventProcessor);
 }
 
 void VyEngine::RegisterDrawable(VyDrawable* drawable) {
 	_drawables.push_back(drawable);
+	// empty, so the first RenderDamage sees its bounds change
+	_drawnBounds.push_back({ 0, 0, 0, 0 });
 }
 
 void VyEngine::UnregisterDrawable(VyDrawable* drawable) {
 	auto found = std::find(_drawables.begin(), _drawables.end(), drawable);
 	if (found == _drawables.end()) { return; }
+	size_t index = found - _drawables.begin();
+	// already on screen, unlike what AddDamage takes
+	if (UseDamageTracking && _rendererKind == Renderer::SDL_Surface) {
+		_damage.Add(_drawnBounds[index]);
+	}
+	_drawnBounds.erase(_drawnBounds.begin() + index);
 	_drawables.erase(found);
 }
 
@@ -252,30 +404,104 @@ void VyEngine::UnregisterUpdatable(VyUpdatable* updatable) {
 	_updatable.erase(found);
 }
 
+void VyEngine::RegisterPointerTarget(VyPointerTarget* target, const Rect& rect) {
+	_hitTest.Add(target, rect);
+}
+
+void VyEngine::MovePointerTarget(VyPointerTarget* target, const Rect& rect) {
+	_hitTest.Move(target, rect);
+}
+
+void VyEngine::SetPointerTargetActive(VyPointerTarget* target, bool active) {
+	_hitTest.SetActive(target, active);
+}
+
+void VyEngine::UnregisterPointerTarget(VyPointerTarget* target) {
+	_hitTest.Remove(target);
+	if (_hoveredTarget == target) { _hoveredTarget = NULL; }
+	if (_focusedTarget == target) { _focusedTarget = NULL; }
+	for (int i = 0; i < SDL_arraysize(_capturedTarget); ++i) {
+		if (_capturedTarget[i] == target) { _capturedTarget[i] = NULL; }
+	}
+}
+
+void VyEngine::UpdateHover() {
+	// in the world, so the hover also changes when the camera moves under a still mouse
+	Coord position = _camera.ScreenToWorld(MousePosition);
+	if (position == _hoverPosition && _hitTest.GetVersion() == _hoverVersion) {
+		return;
+	}
+	_hoverPosition = position;
+	_hoverVersion = _hitTest.GetVersion();
+	VyPointerTarget* hovered = _hitTest.Pick(position);
+	if (hovered == _hoveredTarget) {
+		return;
+	}
+	if (_hoveredTarget != NULL) {
+		_hoveredTarget->SetHovered(false);
+	}
+	_hoveredTarget = hovered;
+	if (_hoveredTarget != NULL) {
+		_hoveredTarget->SetHovered(true);
+	}
+}
+
+void VyEngine::DeliverPointerEvent(VyPointerTarget* target, const SDL_Event& e) {
+	VY_PROFILE_ZONE("VyEngine::DeliverPointerEvent");
+	for (; target != NULL; target = target->GetPointerParent()) {
+		target->HandlePointerEvent(e);
+	}
+}
+
+void VyEngine::ProcessPointerButton(const SDL_Event& e) {
+	UpdateHover();
+	VyPointerTarget*& captured = _capturedTarget[e.button.button & 7];
+	if (e.type == SDL_MOUSEBUTTONDOWN) {
+		// a main click moves the selection, even one the keys moved away from the focused target, or one on nothing. other buttons leave it
+		if (e.button.button == SDL_BUTTON_LEFT) {
+			if (_selection != NULL && dynamic_cast<VyPointerTarget*>(_selection) != _hoveredTarget) { _selection->SetSelected(false); }
+			if (_focusedTarget != NULL && _focusedTarget != _hoveredTarget) { _focusedTarget->SetPointerFocused(false); }
+			_focusedTarget = _hoveredTarget;
+			if (_focusedTarget != NULL) { _focusedTarget->SetPointerFocused(true); }
+		}
+		captured = _hoveredTarget;
+		DeliverPointerEvent(_hoveredTarget, e);
+	} else {
+		VyPointerTarget* target = captured != NULL ? captured : _hoveredTarget;
+		captured = NULL;
+		DeliverPointerEvent(target, e);
+	}
+}
+
 void VyEngine::ProcessEvent(const SDL_Event& e)
 {
+	VY_PROFILE_ZONE("VyEngine::ProcessEvent");
+	VY_PROFILE_COUNTER("events", 1);
 	switch (e.type) {
 	case SDL_QUIT:
 		_running = false;
 		break;
 	case SDL_KEYDOWN:
-		SetPressed(e.key.keysym.sym, true);
+		_inputNext.SetKey(e.key.keysym.scancode, true, e.key.repeat != 0);
 		ProcessDelegates(_keyBindDown, e.key.keysym.sym, e);
 		break;
 	case SDL_KEYUP:
-		SetPressed(e.key.keysym.sym, false);
+		_inputNext.SetKey(e.key.keysym.scancode, false, false);
 		ProcessDelegates(_keyBindUp, e.key.keysym.sym, e);
 		break;
 	case SDL_MOUSEMOTION:
 		MousePosition.x = e.motion.x;
 		MousePosition.y = e.motion.y;
+		_inputNext.mouseDelta += Coord(e.motion.xrel, e.motion.yrel);
+		UpdateHover();
 		//printf("mousemotion x%d, y%d, type%d, dx%d, dy%d\n",
 		//	e.motion.x, e.motion.y, e.motion.type, e.motion.xrel, e.motion.yrel);
 		break;
 	case SDL_MOUSEBUTTONUP:
 		MousePosition.x = e.button.x;
 		MousePosition.y = e.button.y;
-		SetPressed(SDL_MOUSEMOTION | e.button.button, false);
+		_inputNext.SetMouseButton(e.button.button, false);
+		ProcessPointerButton(e);
 		//printf("####################### UP BTN%d   %d\n", e.button.button, e.button.state);
 		ProcessDelegates(_mouseBindUp, e.button.button, e);
 		//printf("mousemotion x%d, y%d, type%d, clicks%d, which%d, state%d, button%d\n",
@@ -284,46 +510,304 @@ void VyEngine::ProcessEvent(const SDL_Event& e)
 	case SDL_MOUSEBUTTONDOWN:
 		MousePosition.x = e.button.x;
 		MousePosition.y = e.button.y;
-		SetPressed(SDL_MOUSEMOTION | e.button.button, true);
+		_inputNext.SetMouseButton(e.button.button, true);
+		ProcessPointerButton(e);
 		//printf("####################### DN BTN%d   %d\n", e.button.button, e.button.state);
 		ProcessDelegates(_mouseBindDown, e.button.button, e);
 		//printf("mousemotion x%d, y%d, type%d, clicks%d, which%d, state%d, button%d\n",
 		//	e.button.x, e.button.y, e.button.type, e.button.clicks, e.button.which, e.button.state, e.button.button);
 		break;
+	case SDL_MOUSEWHEEL:
+		_inputNext.wheel += Coord(e.wheel.x, e.wheel.y);
+		break;
+	case SDL_WINDOWEVENT:
+		if (e.window.event == SDL_WINDOWEVENT_EXPOSED) {
+			DamageAll();
+		}
+		break;
+	}
+	++_processorDispatchDepth;
+	ProcessDelegates(_eventProcessors[(int)VyEventProcessor::GetCategory(e.type)], e);
+	if (--_processorDispatchDepth == 0 && _processorsRemoved) {
+		_processorsRemoved = false;
+		for (std::vector<VyEventProcessor*>& processors : _eventProcessors) {
+			processors.erase(std::remove(processors.begin(), processors.end(), (VyEventProcessor*)NULL), processors.end());
+		}
 	}
-	ProcessDelegates(this->_eventProcessors, e);
 }
 
 void VyEngine::ServiceQueue() {
-	auto temp = _todoNow;
-	_todoNow = _todo;
-	_todo = temp;
-	_todo->clear();
-	for (int i = 0; i < _todoNow->size(); ++i) {
-		//printf("%s\n", (*_todoNow)[i].src.c_str());
-		(*_todoNow)[i].action();
-	}
-	_todoNow->clear();
+	VY_PROFILE_ZONE("VyEngine::ServiceQueue");
+	int count = ServicePhase(Phase::Update);
+	VY_PROFILE_COUNTER("queued actions", (Sint64)count);
 }
 
-void VyEngine::Queue(VyEngine::TriggeredEvent action, std::string src) {
-	_todo->push_back({ src, action });
+int VyEngine::ServicePhase(Phase phase) {
+	return _actions.Service(phase);
 }
 
+void VyEngine::Queue(DeferredAction action, VySourceLocation source, Phase phase) {
+	_actions.Post(std::move(action), source, phase);
+}
 
 void VyEngine::ProcessInput() {
-	SDL_Event e;
-	std::map<int, EventDelegateKeyedList>::iterator found;
-	while (SDL_PollEvent(&e)) {
-		ProcessEvent(e);
+	VY_PROFILE_ZONE("VyEngine::ProcessInput");
+	// a new frame: last frame's scratch memory is no longer in use
+	_frameArena->Reset();
+	ServicePhase(Phase::NextFrame);
+	_hasPendingMotion = false;
+	_coalescedMotion = 0;
+	if (_recorder != NULL) {
+		_recorder->BeginFrame();
+	}
+	// drained in bulk: one lock of SDL's queue per batch instead of per event
+	SDL_PumpEvents();
+	SDL_Event events[64];
+	int count;
+	do {
+		count = SDL_PeepEvents(events, (int)SDL_arraysize(events), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+		if (_replay != NULL) {
+			// live input would make the replay diverge. only quitting gets through
+			for (int i = 0; i < count; ++i) {
+				if (events[i].type == SDL_QUIT) { ProcessEvent(events[i]); }
+			}
+			continue;
+		}
+		for (int i = 0; i < count; ++i) {
+			if (_recorder != NULL) {
+				_recorder->Record(events[i]);
+			}
+			ConsumeEvent(events[i]);
+		}
+	} while (count == (int)SDL_arraysize(events));
+	if (_replay != NULL) {
+		ReplayFrame();
+	}
+	if (_hasPendingMotion) {
+		_hasPendingMotion = false;
+		ProcessEvent(_pendingMotion);
+	}
+	VY_PROFILE_COUNTER("coalesced motion", (Sint64)_coalescedMotion);
+	// targets may have moved under a still mouse
+	UpdateHover();
+	_inputNext.mousePosition = MousePosition;
+	_input = _inputNext;
+	_inputNext.BeginFrame();
+	ServicePhase(Phase::AfterInput);
+}
+
+void VyEngine::ConsumeEvent(const SDL_Event& e) {
+	if (CoalesceMouseMotion && e.type == SDL_MOUSEMOTION) {
+		if (_hasPendingMotion && e.motion.which == _pendingMotion.motion.which && e.motion.windowID == _pendingMotion.motion.windowID) {
+			CoalesceMotion(_pendingMotion, e);
+			++_coalescedMotion;
+			return;
+		}
+		if (_hasPendingMotion) {
+			ProcessEvent(_pendingMotion);
+		}
+		_pendingMotion = e;
+		_hasPendingMotion = true;
+		return;
+	}
+	// anything else ends the run, so buttons and keys still see the mouse where it was when they happened
+	if (_hasPendingMotion) {
+		_hasPendingMotion = false;
+		ProcessEvent(_pendingMotion);
+	}
+	ProcessEvent(e);
+}
+
+void VyEngine::ReplayFrame() {
+	if (_replayFrame >= _replay->GetFrameCount()) {
+		// a load test is over when its input is
+		StopReplay();
+		_running = false;
+		return;
+	}
+	int count;
+	const SDL_Event* events = _replay->GetEvents(_replayFrame, count);
+	for (int i = 0; i < count; ++i) {
+		ConsumeEvent(events[i]);
+	}
+	_replaySteps = _replay->GetSteps(_replayFrame);
+	++_replayFrame;
+}
+
+VyEngine::ErrorCode VyEngine::StartRecording(std::string path) {
+	if (_recorder == NULL) {
+		_recorder = new VyInputRecorder();
+	}
+	if (!_recorder->Start(path, ErrorMessage)) {
+		return ErrorCode::Failure;
+	}
+	return ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyEngine::StopRecording() {
+	if (_recorder == NULL || _recorder->Stop(ErrorMessage)) {
+		return ErrorCode::Success;
 	}
+	return ErrorCode::Failure;
+}
+
+bool VyEngine::IsRecording() const { return _recorder != NULL && _recorder->IsRecording(); }
+
+VyEngine::ErrorCode VyEngine::StartReplay(std::string path) {
+	VyInputReplay* replay = new VyInputReplay();
+	if (!replay->Load(path, ErrorMessage)) {
+		delete replay;
+		return ErrorCode::Failure;
+	}
+	StopReplay();
+	_replay = replay;
+	_replayFrame = 0;
+	_replaySteps = 1;
+	return ErrorCode::Success;
+}
+
+void VyEngine::StopReplay() {
+	delete _replay;
+	_replay = NULL;
+}
+
+bool VyEngine::IsReplaying() const { return _replay != NULL; }
+
+void VyEngine::CoalesceMotion(SDL_Event& into, const SDL_Event& next) {
+	into.motion.timestamp = next.motion.timestamp;
+	into.motion.state = next.motion.state;
+	into.motion.x = next.motion.x;
+	into.motion.y = next.motion.y;
+	into.motion.xrel += next.motion.xrel;
+	into.motion.yrel += next.motion.yrel;
 }
 
 void VyEngine::Update() {
+	VY_PROFILE_ZONE("VyEngine::Update");
+	ProcessUpdatables();
+	ServiceQueue();
+}
+
+void VyEngine::ProcessUpdatables() {
+	VY_PROFILE_ZONE("VyEngine::ProcessUpdatables");
+	if (!UseParallelUpdate) {
+		for (int b = 0; b < _updatable.size(); ++b) {
+			_updatable[b]->Update();
+		}
+		return;
+	}
+	_parallelUpdatable.clear();
+	_serialUpdatable.clear();
 	for (int b = 0; b < _updatable.size(); ++b) {
-		_updatable[b]->Update();
+		(_updatable[b]->IsParallelSafe() ? _parallelUpdatable : _serialUpdatable).push_back(_updatable[b]);
+	}
+	VY_PROFILE_COUNTER("parallel updatables", (Sint64)_parallelUpdatable.size());
+	// returns once every chunk is done: the barrier before the serial updatables and ServiceQueue
+	GetJobSystem()->ParallelFor((int)_parallelUpdatable.size(), ParallelUpdateChunk, [this](int begin, int end) {
+		for (int b = begin; b < end; ++b) {
+			_parallelUpdatable[b]->Update();
+		}
+	});
+	for (int b = 0; b < _serialUpdatable.size(); ++b) {
+		_serialUpdatable[b]->Update();
 	}
-	ServiceQueue();
+}
+
+VyJobSystem* VyEngine::GetJobSystem() {
+	if (_jobs == NULL) {
+		_jobs = new VyJobSystem();
+	}
+	return _jobs;
+}
+
+VyEngine::ErrorCode VyEngine::Run(TriggeredEvent onDraw) {
+	// written so NaN fails too
+	if (!(FixedTimestep > 0)) {
+		ErrorMessage = string_format("FixedTimestep must be above 0, not %f", FixedTimestep);
+		return ErrorCode::InputError;
+	}
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	// offscreen frames aren't shown, so there's nothing to pace to
+	const Uint64 frameTicks = _rendererKind == Renderer::Offscreen ? 0 : (Uint64)(TargetFrameTime * frequency);
+	Uint64 previous = SDL_GetPerformanceCounter();
+	Uint64 deadline = previous + frameTicks;
+	double accumulator = 0;
+	while (IsRunning()) {
+		Uint64 frameStart = SDL_GetPerformanceCounter();
+		accumulator += (double)(frameStart - previous) / frequency;
+		previous = frameStart;
+		bool replaying = IsReplaying();
+		ProcessInput();
+		if (ErrorMessage != "") { return ErrorCode::Failure; }
+		if (replaying && !IsReplaying()) {
+			// ran out of recorded frames
+			break;
+		}
+		if (_assetLoader != NULL) {
+			ProcessAssetUploads(AssetUploadBudget);
+		}
+		int steps = 0;
+		if (replaying) {
+			// the recorded frame's updates, whatever the clock says, so the simulation follows the same path
+			for (; steps < _replaySteps; ++steps) {
+				Update();
+				if (ErrorMessage != "") { return ErrorCode::Failure; }
+			}
+			accumulator = 0;
+		}
+		while (!replaying && accumulator >= FixedTimestep && steps < MaxCatchUpSteps) {
+			Update();
+			if (ErrorMessage != "") { return ErrorCode::Failure; }
+			accumulator -= FixedTimestep;
+			++steps;
+		}
+		if (accumulator >= FixedTimestep) {
+			// too far behind to catch up: drop whole steps rather than spiral
+			accumulator = fmod(accumulator, FixedTimestep);
+		}
+		if (_recorder != NULL) {
+			_recorder->SetSteps(steps);
+		}
+		_interpolationAlpha = accumulator / FixedTimestep;
+		ClearGraphics();
+		if (onDraw) {
+			onDraw();
+		}
+		Render();
+		if (ErrorMessage != "") { return ErrorCode::Failure; }
+		Uint64 frameEnd = SDL_GetPerformanceCounter();
+		_frameWorkTime = (double)(frameEnd - frameStart) / frequency;
+		if (frameTicks == 0 || replaying) {
+			continue;
+		}
+		if (frameEnd > deadline + frameTicks) {
+			// missed by more than a whole frame: start pacing again from now instead of rushing the next frames
+			deadline = frameEnd;
+		}
+		WaitUntil(deadline);
+		deadline += frameTicks;
+	}
+	return ErrorCode::Success;
+}
+
+double VyEngine::GetInterpolationAlpha() const { return _interpolationAlpha; }
+
+double VyEngine::GetFrameWorkTime() const { return _frameWorkTime; }
+
+/// <summary>
+/// sleep while the deadline is comfortably far away (SDL_Delay can overshoot by a scheduler tick), then spin the rest
+/// </summary>
+void VyEngine::WaitUntil(Uint64 deadline) {
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	const Uint64 spinTicks = frequency / 500; // 2ms
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (now + spinTicks < deadline) {
+		Uint32 sleepMs = (Uint32)((deadline - now - spinTicks) * 1000 / frequency);
+		if (sleepMs > 0) {
+			SDL_Delay(sleepMs);
+		}
+	}
+	while (SDL_GetPerformanceCounter() < deadline) {}
 }
 
 VyEngine::ErrorCode VyEngine::InitSDL_Surface() {
@@ -334,11 +818,44 @@ VyEngine::ErrorCode VyEngine::InitSDL_Surface() {
 		return VyEngine::ErrorCode::WindowCreationFailure;
 	}
 	SDL_FillRect(_screenSurface, NULL, SDL_MapRGB(_screenSurface->format, 0xFF, 0xFF, 0xFF));
+	// drawables draw into the window surface through this, so they work the same in both modes
+	_renderer = SDL_CreateSoftwareRenderer(_screenSurface);
+	if (_renderer == NULL)
+	{
+		ErrorMessage = string_format("Software renderer could not be created! SDL Error: %s\n", SDL_GetError());
+		return VyEngine::ErrorCode::WindowCreationFailure;
+	}
+	_primitiveBatch = new VyPrimitiveBatch(_renderer);
+	_damage.SetSize(_screenSurface->w, _screenSurface->h);
+	return VyEngine::ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyEngine::InitOffscreen() {
+	// the format textures and the software renderer handle fastest, and what ReadPixels hands out
+	_screenSurface = SDL_CreateRGBSurfaceWithFormat(0, _width, _height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (_screenSurface == NULL)
+	{
+		ErrorMessage = string_format("Offscreen surface could not be created! SDL_Error: %s", SDL_GetError());
+		return VyEngine::ErrorCode::WindowCreationFailure;
+	}
+	_renderer = SDL_CreateSoftwareRenderer(_screenSurface);
+	if (_renderer == NULL)
+	{
+		ErrorMessage = string_format("Software renderer could not be created! SDL Error: %s\n", SDL_GetError());
+		return VyEngine::ErrorCode::WindowCreationFailure;
+	}
+	// from here on the same as a window's renderer, textures and all
+	SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(_renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+	_atlas = new VyTextureAtlas(_renderer);
+	_spriteBatch = new VySpriteBatch(_renderer);
+	_renderQueue = new VyRenderQueue(_renderer);
+	_primitiveBatch = new VyPrimitiveBatch(_renderer);
 	return VyEngine::ErrorCode::Success;
 }
 
 VyEngine::ErrorCode VyEngine::InitSDL_Renderer() {
-	_renderer = SDL_CreateRenderer(_window, -1, SDL_RENDERER_ACCELERATED);
+	_renderer = SDL_CreateRenderer(_window, -1, RendererFlags);
 	if (_renderer == NULL)
 	{
 		ErrorMessage = string_format("Renderer could not be created! SDL Error: %s\n", SDL_GetError());
@@ -346,67 +863,58 @@ VyEngine::ErrorCode VyEngine::InitSDL_Renderer() {
 	}
 	SDL_SetRenderDrawBlendMode(_renderer, SDL_BLENDMODE_BLEND);
 	SDL_SetRenderDrawColor(_renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+	_atlas = new VyTextureAtlas(_renderer);
+	_spriteBatch = new VySpriteBatch(_renderer);
+	_renderQueue = new VyRenderQueue(_renderer);
+	_primitiveBatch = new VyPrimitiveBatch(_renderer);
 	return VyEngine::ErrorCode::Success;
 }
 
-VyEngine::ErrorCode VyEngine::SetPressed(int sdlk, bool pressed) {
-	// TODO do some performance analysis. is int faster than longlong and unsignedchar?
-	int* field = NULL;
+VyEngine::ErrorCode VyEngine::DecodeInputCode(int sdlk, bool& out_isMouse, int& out_index) {
+	out_isMouse = false;
 	if (sdlk >= 0 && sdlk < 256) {
-		field = this->_isPressedKeyMask;
+		out_index = SDL_GetScancodeFromKey(sdlk);
 	} else if ((sdlk & SDL_MOUSEMOTION) != 0) {
-		sdlk -= SDL_MOUSEMOTION;
-		field = this->_isMousePressed;
-		//printf("~~%d\n", sdlk);
+		out_isMouse = true;
+		out_index = sdlk - SDL_MOUSEMOTION;
 	} else if ((sdlk & SDLK_SCANCODE_MASK) != 0) {
-		sdlk -= SDLK_SCANCODE_MASK;
-		field = this->_isPressedKeyMaskScancode;
+		out_index = sdlk - SDLK_SCANCODE_MASK;
+		if (out_index < 0 || out_index >= SDL_NUM_SCANCODES) {
 #ifndef NDEBUG
-		if (sdlk < 0 || sdlk >= SDL_NUM_SCANCODES) {
-			ErrorMessage = string_format("Unknown scancode %d", sdlk);
+			ErrorMessage = string_format("Unknown scancode %d", out_index);
+#endif
 			return ErrorCode::InputError;
 		}
 	} else {
+		// release builds only report it through the result, so an unknown key isn't fatal to Run
+#ifndef NDEBUG
 		ErrorMessage = string_format("Unknown keycode %d", sdlk);
-		return ErrorCode::InputError;
 #endif
+		return ErrorCode::InputError;
 	}
-	int intIndex = sdlk >> 5; // bitwise equivalent of / 32
-	int bitIndex = sdlk & ((1 << 5) - 1);
-	field += intIndex;
-	//printf("\npressed(%d) %d: %d %d\n", pressed, sdlk, intIndex, bitIndex);
-	if (pressed) {
-		*field |= (1 << bitIndex);
+	return ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyEngine::SetPressed(int sdlk, bool pressed) {
+	bool isMouse;
+	int index;
+	ErrorCode err = DecodeInputCode(sdlk, isMouse, index);
+	if (err != ErrorCode::Success) { return err; }
+	if (isMouse) {
+		_inputNext.SetMouseButton(index, pressed);
 	} else {
-		*field &= ~(1 << bitIndex);
+		_inputNext.SetKey((SDL_Scancode)index, pressed, false);
 	}
 	return ErrorCode::Success;
 }
 
 VyEngine::ErrorCode VyEngine::IsPressed(int sdlk, bool& out_pressed) {
-	int* field = NULL;
-	if (sdlk >= 0 && sdlk < 256) {
-		field = this->_isPressedKeyMask;
-	} else if ((sdlk & SDL_MOUSEMOTION) != 0) {
-		sdlk -= SDL_MOUSEMOTION;
-		field = this->_isMousePressed;
-	} else if ((sdlk & SDLK_SCANCODE_MASK) != 0) {
-		sdlk -= SDLK_SCANCODE_MASK;
-		field = this->_isPressedKeyMaskScancode;
-#ifndef NDEBUG
-		if (sdlk < 0 || sdlk >= SDL_NUM_SCANCODES) {
-			ErrorMessage = string_format("Unknown scancode %d", sdlk);
-			return ErrorCode::InputError;
-		}
-	} else {
-		ErrorMessage = string_format("Unknown keycode %d", sdlk);
-		return ErrorCode::InputError;
-#endif
-	}
-	int intIndex = sdlk >> 5; // bitwise equivalent of / 32
-	int bitIndex = sdlk & ((1 << 5) - 1);
-	field += intIndex;
-	out_pressed = (*field & (1 << bitIndex)) != 0;
+	bool isMouse;
+	int index;
+	ErrorCode err = DecodeInputCode(sdlk, isMouse, index);
+	if (err != ErrorCode::Success) { return err; }
+	// the state being written, so a key or mouse delegate sees the press it was called for
+	out_pressed = isMouse ? _inputNext.IsMouseHeld(index) : _inputNext.IsHeld((SDL_Scancode)index);
 	return ErrorCode::Success;
 }
 
@@ -470,38 +978,378 @@ VyEngine::ErrorCode VyEngine::LoadSdlSurface(std::string path, SDL_Surface*& out
 }
 
 VyEngine::ErrorCode VyEngine::LoadSdlTexture(std::string path, SDL_Texture*& out_texture) {
+	TextureHandle handle;
+	ErrorCode err = AcquireTexture(path, handle);
+	out_texture = GetTexture(handle);
+	return err;
+}
+
+VyEngine::ErrorCode VyEngine::LoadSdlTexture(SDL_Surface* loadedSurface, SDL_Texture*& out_texture) {
+	out_texture = SDL_CreateTextureFromSurface(_renderer, loadedSurface);
+	if (out_texture == NULL) {
+		ErrorMessage = string_format("Unable to create texture from SDL_Surface! SDL Error: %s\n", SDL_GetError());
+		return ErrorCode::Failure;
+	}
+	ManageTexture(out_texture, "");
+	return ErrorCode::Success;
+}
+
+std::string VyEngine::TextureKey(const std::string& path) {
+	return "texture:" + path;
+}
+
+VyEngine::TextureHandle VyEngine::ManageTexture(SDL_Texture* texture, const std::string& key) {
+	TextureHandle handle = _textures.Acquire(texture, key);
+	_textureHandles[texture] = handle;
+	return handle;
+}
+
+VyEngine::ErrorCode VyEngine::AcquireTexture(std::string path, TextureHandle& out_handle) {
+	std::string key = TextureKey(path);
+	out_handle = _textures.AcquireExisting(key);
+	if (!out_handle.IsNull()) {
+		return ErrorCode::Success;
+	}
 	SDL_Surface* loadedSurface = NULL;
 	ErrorCode err = LoadSdlSurfaceBasic(path, loadedSurface);
 	if (err != ErrorCode::Success) { return err; }
-	err = LoadSdlTexture(loadedSurface, out_texture);
-	if (err != ErrorCode::Success) {
+	SDL_Texture* texture = SDL_CreateTextureFromSurface(_renderer, loadedSurface);
+	SDL_FreeSurface(loadedSurface);
+	if (texture == NULL) {
 		ErrorMessage = string_format("Unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
-		return err;
+		return ErrorCode::Failure;
 	}
-	////printf("have img %x\n", loadedSurface);
-	//out_texture = SDL_CreateTextureFromSurface(_renderer, loadedSurface);
-	//if (out_texture == NULL) {
-	//	ErrorMessage = string_format("Unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
-	//	return ErrorCode::Failure;
-	//}
-	//_managedTextures.push_back(out_texture);
-	SDL_FreeSurface(loadedSurface);
+	out_handle = ManageTexture(texture, key);
 	return ErrorCode::Success;
 }
 
-VyEngine::ErrorCode VyEngine::LoadSdlTexture(SDL_Surface* loadedSurface, SDL_Texture*& out_texture) {
-	out_texture = SDL_CreateTextureFromSurface(_renderer, loadedSurface);
-	if (out_texture == NULL) {
-		ErrorMessage = string_format("Unable to create texture from SDL_Surface! SDL Error: %s\n", SDL_GetError());
-		return ErrorCode::Failure;
+SDL_Texture* VyEngine::GetTexture(TextureHandle handle) const {
+	SDL_Texture* const* texture = _textures.Get(handle);
+	return texture != NULL ? *texture : NULL;
+}
+
+void VyEngine::ReleaseTexture(TextureHandle handle) {
+	SDL_Texture* texture = NULL;
+	if (_textures.Release(handle, texture)) {
+		_textureHandles.erase(texture);
+		SDL_DestroyTexture(texture);
+	}
+}
+
+VyAssetLoader* VyEngine::GetAssetLoader() {
+	if (_assetLoader == NULL) {
+		_assetLoader = new VyAssetLoader();
+	}
+	return _assetLoader;
+}
+
+VyAssetHandle VyEngine::LoadSdlSurfaceAsync(std::string path) {
+	std::shared_ptr<VyAssetRequest> request(new VyAssetRequest(VyAssetRequest::Kind::Surface, path));
+	request->pixelFormat = _screenSurface != NULL ? _screenSurface->format->format : SDL_PIXELFORMAT_ARGB8888;
+	GetAssetLoader()->Submit(request);
+	return VyAssetHandle(request);
+}
+
+VyAssetHandle VyEngine::LoadSdlTextureAsync(std::string path) {
+	std::shared_ptr<VyAssetRequest> request(new VyAssetRequest(VyAssetRequest::Kind::Texture, path));
+	TextureHandle existing = _textures.AcquireExisting(TextureKey(path));
+	if (!existing.IsNull()) {
+		request->texture = GetTexture(existing);
+		request->state = VyAssetRequest::State::Ready;
+		return VyAssetHandle(request);
+	}
+	// a format textures take directly, so the upload doesn't convert on the main thread
+	request->pixelFormat = SDL_PIXELFORMAT_ARGB8888;
+	GetAssetLoader()->Submit(request);
+	return VyAssetHandle(request);
+}
+
+VyAssetHandle VyEngine::SetFontAsync(std::string fontName, int size) {
+	std::string path = string_format("font/%s.ttf", fontName.c_str());
+	std::shared_ptr<VyAssetRequest> request(new VyAssetRequest(VyAssetRequest::Kind::Font, path));
+	request->fontName = fontName;
+	request->fontSize = size;
+	FontId font = RegisterFont(fontName, size);
+	if (_fontCache->IsOpen(font) || _fontCache->IsFileLoaded(fontName)) {
+		// nothing to read: opening a size from the cached file is cheap
+		if (SetFont(font) != VyEngine::ErrorCode::Success) {
+			request->error = ErrorMessage;
+			request->state = VyAssetRequest::State::Failed;
+			return VyAssetHandle(request);
+		}
+		request->font = _currentFont;
+		request->state = VyAssetRequest::State::Ready;
+		return VyAssetHandle(request);
+	}
+	GetAssetLoader()->Submit(request);
+	return VyAssetHandle(request);
+}
+
+void VyEngine::FinishAsset(VyAssetRequest& request) {
+	VY_PROFILE_ZONE("VyEngine::FinishAsset");
+	if (request.error != "") {
+		SDL_FreeSurface(request.surface);
+		request.surface = NULL;
+		SDL_free(request.fontData);
+		request.fontData = NULL;
+		request.state = VyAssetRequest::State::Failed;
+		return;
+	}
+	switch (request.kind) {
+	case VyAssetRequest::Kind::Surface:
+		_managedSurfaces.push_back(request.surface);
+		break;
+	case VyAssetRequest::Kind::Texture: {
+		TextureHandle existing = _textures.AcquireExisting(TextureKey(request.path));
+		if (!existing.IsNull()) {
+			// loaded by someone else while this was decoding
+			SDL_FreeSurface(request.surface);
+			request.surface = NULL;
+			request.texture = GetTexture(existing);
+			break;
+		}
+		request.texture = SDL_CreateTextureFromSurface(_renderer, request.surface);
+		SDL_FreeSurface(request.surface);
+		request.surface = NULL;
+		if (request.texture == NULL) {
+			request.error = string_format("Unable to create texture from %s! SDL Error: %s\n", request.path.c_str(), SDL_GetError());
+			request.state = VyAssetRequest::State::Failed;
+			return;
+		}
+		ManageTexture(request.texture, TextureKey(request.path));
+		}break;
+	case VyAssetRequest::Kind::Font: {
+		if (!_fontCache->AdoptFile(request.fontName, request.fontData, request.fontDataSize)) {
+			// read by SetFont while this was loading
+			SDL_free(request.fontData);
+		}
+		request.fontData = NULL;
+		if (SetFont(RegisterFont(request.fontName, request.fontSize)) != VyEngine::ErrorCode::Success) {
+			request.error = ErrorMessage;
+			request.state = VyAssetRequest::State::Failed;
+			return;
+		}
+		request.font = _currentFont;
+		}break;
+	}
+	request.state = VyAssetRequest::State::Ready;
+}
+
+void VyEngine::ProcessAssetUploads(double budgetSeconds) {
+	if (_assetLoader == NULL) { return; }
+	VY_PROFILE_ZONE("VyEngine::ProcessAssetUploads");
+	const Uint64 frequency = SDL_GetPerformanceFrequency();
+	Uint64 start = SDL_GetPerformanceCounter();
+	std::shared_ptr<VyAssetRequest> request;
+	while (_assetLoader->PopDecoded(request)) {
+		FinishAsset(*request);
+		request->NotifyDone();
+		if ((double)(SDL_GetPerformanceCounter() - start) / frequency >= budgetSeconds) {
+			break;
+		}
+	}
+}
+
+VyEngine::ErrorCode VyEngine::WaitForAsset(const VyAssetHandle& handle) {
+	if (!handle.IsValid()) {
+		ErrorMessage = "Waiting for an invalid asset handle\n";
+		return ErrorCode::InputError;
+	}
+	while (!handle.IsDone()) {
+		ProcessAssetUploads(1e9);
+		if (!handle.IsDone()) {
+			_assetLoader->WaitForDecoded(100);
+		}
+	}
+	if (handle.IsFailed()) {
+		ErrorMessage = handle.GetError();
+		return ErrorCode::MissingResource;
 	}
-	_managedTextures.push_back((size_t)out_texture);
 	return ErrorCode::Success;
 }
 
+VyEngine::ErrorCode VyEngine::LoadAtlasSprite(std::string path, VyAtlasSprite& out_sprite) {
+	SDL_Surface* loadedSurface = NULL;
+	ErrorCode err = LoadSdlSurfaceBasic(path, loadedSurface);
+	if (err != ErrorCode::Success) { return err; }
+	err = LoadAtlasSprite(loadedSurface, out_sprite);
+	SDL_FreeSurface(loadedSurface);
+	return err;
+}
+
+VyEngine::ErrorCode VyEngine::LoadAtlasSprite(SDL_Surface* loadedSurface, VyAtlasSprite& out_sprite) {
+	if (_atlas == NULL) {
+		ErrorMessage = "Atlas sprites need Renderer::SDL_Renderer or Renderer::Offscreen\n";
+		return ErrorCode::NotImplemented;
+	}
+	return _atlas->Add(loadedSurface, out_sprite);
+}
+
+VyTextureAtlas* VyEngine::GetAtlas() { return _atlas; }
+
+VySpriteBatch* VyEngine::GetSpriteBatch() { return _spriteBatch; }
+
+VyRenderQueue* VyEngine::GetRenderQueue() { return _renderQueue; }
+
+void VyEngine::AddDamage(const SDL_Rect& rect) {
+	if (!UseDamageTracking || _rendererKind != Renderer::SDL_Surface) { return; }
+	_damage.Add(_camera.WorldToScreen(rect));
+}
+
+void VyEngine::DamageAll() {
+	if (!UseDamageTracking || _rendererKind != Renderer::SDL_Surface) { return; }
+	_damage.AddAll();
+}
+
+void VyEngine::RenderDamage(SDL_Renderer* g) {
+	VY_PROFILE_ZONE("VyEngine::RenderDamage");
+	if (_camera.GetVersion() != _drawnCameraVersion) {
+		// scrolled or zoomed: everything on screen moved
+		_drawnCameraVersion = _camera.GetVersion();
+		DamageAll();
+	}
+	// damage and drawn bounds are kept on screen, drawables report theirs in the world
+	SDL_Rect bounds;
+	for (int b = 0; b < _drawables.size(); ++b) {
+		// appeared, moved or resized: redraw where it was and where it is
+		if (_drawables[b]->GetDrawBounds(bounds)) {
+			bounds = _camera.WorldToScreen(bounds);
+			if (!SDL_RectEquals(&bounds, &_drawnBounds[b])) {
+				_damage.Add(_drawnBounds[b]);
+				_damage.Add(bounds);
+				_drawnBounds[b] = bounds;
+			}
+		}
+	}
+	if (_damage.IsEmpty()) { return; }
+	// culled once for every damage rect, so each drawable counts once
+	_visibleDrawables.clear();
+	for (int d = 0; d < _drawables.size(); ++d) {
+		if (UseCulling && _camera.IsCulled(_drawables[d])) { continue; }
+		_visibleDrawables.push_back(_drawables[d]);
+	}
+	VY_PROFILE_COUNTER("damage rects", (Sint64)_damage.GetRects().size());
+	VY_PROFILE_COUNTER("damage pixels", (Sint64)_damage.GetArea());
+	// copied out and cleared first, so damage reported while drawing is kept for the next frame
+	_presentRects.assign(_damage.GetRects().begin(), _damage.GetRects().end());
+	_damage.Clear();
+	Uint8 r, g_, b_, a;
+	SDL_GetRenderDrawColor(g, &r, &g_, &b_, &a);
+	for (int i = 0; i < _presentRects.size(); ++i) {
+		// the damage in the world, and where it is drawn, before the renderer's scale, which clip rects are in too
+		SDL_Rect area = _camera.ScreenToWorld(_presentRects[i]);
+		SDL_Rect clip = _camera.ToDraw(area);
+		SDL_RenderSetClipRect(g, &clip);
+		// the same background as ClearGraphics, opaque so it replaces whatever the blend mode
+		SDL_SetRenderDrawColor(g, 0xFF, 0xFF, 0xFF, 0xFF);
+		SDL_RenderFillRect(g, &clip);
+		SDL_SetRenderDrawColor(g, r, g_, b_, a);
+		for (VyDrawable* drawable : _visibleDrawables) {
+			if (drawable->GetDrawBounds(bounds) && !SDL_HasIntersection(&bounds, &area)) {
+				continue;
+			}
+			drawable->Draw(g, _camera.GetDrawOffset());
+		}
+		// batched draws have to land inside this clip rect
+		FlushBatches();
+	}
+	SDL_RenderSetClipRect(g, NULL);
+}
+
+void VyEngine::FlushRenderQueue() {
+	if (_renderQueue->IsEmpty()) { return; }
+	// batches were filled by direct drawables that came before everything now in the queue
+	FlushBatches();
+	_renderQueue->Flush();
+}
+
+void VyEngine::SetDrawOffset(const Coord& offset) {
+	if (_spriteBatch != NULL) {
+		_spriteBatch->SetOffset(offset);
+	}
+	if (_primitiveBatch != NULL) {
+		_primitiveBatch->SetOffset(offset);
+	}
+	if (_renderQueue != NULL) {
+		_renderQueue->SetOffset(offset);
+	}
+}
+
+void VyEngine::FlushBatches() {
+	if (_spriteBatch != NULL) {
+		_spriteBatch->Flush();
+	}
+	if (_primitiveBatch != NULL) {
+		_primitiveBatch->Flush();
+	}
+}
+
+VyPrimitiveBatch* VyEngine::GetPrimitiveBatch() { return _primitiveBatch; }
+
+VyGlyphCache* VyEngine::GetGlyphCache() {
+	if (_atlas == NULL || _currentFont == NULL) {
+		return NULL;
+	}
+	VyGlyphCache*& cache = _glyphCaches[_currentFontId];
+	if (cache == NULL) {
+		cache = new VyGlyphCache(_currentFont, _atlas);
+		_fontCache->Pin(_currentFontId);
+	}
+	return cache;
+}
+
+VyCircleCache* VyEngine::GetCircleCache() {
+	if (_atlas == NULL) {
+		return NULL;
+	}
+	if (_circleCache == NULL) {
+		_circleCache = new VyCircleCache(_atlas);
+	}
+	return _circleCache;
+}
+
 void VyEngine::ReleaseSdlTexture(SDL_Texture* texture) {
-	auto end = _managedTextures.end();
-	_managedTextures.erase(std::remove(_managedTextures.begin(), end, (size_t)texture), end);
+	auto found = _textureHandles.find(texture);
+	if (found == _textureHandles.end()) { return; }
+	ReleaseTexture(found->second);
+}
+
+VyEngine::ErrorCode VyEngine::ReadPixels(SDL_Surface*& out_surface, const SDL_Rect* area) {
+	out_surface = NULL;
+	if (_renderer == NULL) {
+		ErrorMessage = "Nothing to read pixels from before Init\n";
+		return ErrorCode::Failure;
+	}
+	SDL_Rect screen = { 0, 0, 0, 0 };
+	SDL_GetRendererOutputSize(_renderer, &screen.w, &screen.h);
+	SDL_Rect read = screen;
+	if (area != NULL && !SDL_IntersectRect(area, &screen, &read)) {
+		read.w = read.h = 0;
+	}
+	out_surface = SDL_CreateRGBSurfaceWithFormat(0, read.w, read.h, 32, SDL_PIXELFORMAT_ARGB8888);
+	ErrorCode err = ErrorCode::Success;
+	if (out_surface == NULL) {
+		ErrorMessage = string_format("Surface for pixels could not be created! SDL_Error: %s\n", SDL_GetError());
+		err = ErrorCode::Failure;
+	} else if (read.w > 0 && read.h > 0 && SDL_RenderReadPixels(_renderer, &read, SDL_PIXELFORMAT_ARGB8888, out_surface->pixels, out_surface->pitch) != 0) {
+		ErrorMessage = string_format("Pixels could not be read! SDL_Error: %s\n", SDL_GetError());
+		SDL_FreeSurface(out_surface);
+		out_surface = NULL;
+		err = ErrorCode::Failure;
+	}
+	return err;
+}
+
+VyEngine::ErrorCode VyEngine::SaveScreenshot(std::string path) {
+	SDL_Surface* pixels = NULL;
+	ErrorCode err = ReadPixels(pixels);
+	if (err != ErrorCode::Success) { return err; }
+	if (IMG_SavePNG(pixels, path.c_str()) != 0) {
+		ErrorMessage = string_format("Unable to save %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+		err = ErrorCode::Failure;
+	}
+	SDL_FreeSurface(pixels);
+	return err;
 }
 
 Coord VyEngine::GetTextureSize(SDL_Texture* texture) {
@@ -522,61 +1370,43 @@ VyEngine::ErrorCode VyEngine::CreateText(std::string text, SDL_Texture*& out_tex
 		return ErrorCode::Failure;
 	}
 	SDL_FreeSurface(loadedSurface);
-	_managedTextures.push_back((size_t)out_texture);
+	ManageTexture(out_texture, "");
 	return ErrorCode::Success;
 }
 
-void AddDelegateToList(VyEngine::EventDelegateListMap& map, int button, size_t owner, VyEngine::EventDelegate eventDelegate) {
-	VyEngine::EventDelegateKeyedList* list = NULL;
-	auto found = map.find(button);
-	if (found != map.end()) {
-		list = &found->second;
-	} else {
-		map[button] = VyEngine::EventDelegateKeyedList();
-		auto found = map.find(button);
-		list = &found->second;
-	}
-	(*list)[owner] = eventDelegate;
-}
-
-void RemoveDelegateFromList(VyEngine::EventDelegateListMap& map, int button, size_t owner) {
-	auto found = map.find(button);
-	if (found == map.end()) { return; }
-	found->second.erase(owner);
-}
-
 void VyEngine::RegisterMouseDown(int button, size_t owner, VyEngine::EventDelegate eventDelegate) {
 	button &= ~SDL_MOUSEMOTION;
-	AddDelegateToList(_mouseBindDown, button, owner, eventDelegate);
+	_mouseBindDown.Register(button, owner, std::move(eventDelegate));
 }
 
 void VyEngine::RegisterMouseUp(int button, size_t owner, VyEngine::EventDelegate eventDelegate) {
 	button &= ~SDL_MOUSEMOTION;
-	AddDelegateToList(_mouseBindUp, button, owner, eventDelegate);
+	_mouseBindUp.Register(button, owner, std::move(eventDelegate));
 }
 
 void VyEngine::RegisterKeyDown(int button, size_t owner, VyEngine::EventDelegate eventDelegate) {
-	AddDelegateToList(_keyBindDown, button, owner, eventDelegate);
+	_keyBindDown.Register(button, owner, std::move(eventDelegate));
 }
 
 void VyEngine::RegisterKeyUp(int button, size_t owner, VyEngine::EventDelegate eventDelegate) {
-	AddDelegateToList(_keyBindUp, button, owner, eventDelegate);
+	_keyBindUp.Register(button, owner, std::move(eventDelegate));
 }
 
 void VyEngine::UnregisterMouseDown(int button, size_t owner) {
-	RemoveDelegateFromList(_mouseBindDown, button, owner);
+	button &= ~SDL_MOUSEMOTION;
+	_mouseBindDown.Unregister(button, owner);
 }
 
 void VyEngine::UnregisterMouseUp(int button, size_t owner) {
-	RemoveDelegateFromList(_mouseBindUp, button, owner);
+	button &= ~SDL_MOUSEMOTION;
+	_mouseBindUp.Unregister(button, owner);
 }
 
 void VyEngine::UnregisterKeyDown(int button, size_t owner) {
-	RemoveDelegateFromList(_keyBindDown, button, owner);
+	_keyBindDown.Unregister(button, owner);
 }
 
 void VyEngine::UnregisterKeyUp(int button, size_t owner) {
-	RemoveDelegateFromList(_keyBindUp, button, owner);
+	_keyBindUp.Unregister(button, owner);
 }
 
-#undef CLEAR_ARRAY
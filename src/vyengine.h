@@ -7,10 +7,33 @@
 #include <map>
 #include <functional>
 #include <vector>
+#include <unordered_map>
 #include "coord.h"
 #include "rect.h"
 #include "sdlhelper.h"
 #include "sdleventprocessor.h"
+#include "vydelegatetable.h"
+#include "vyinput.h"
+#include "vyhittest.h"
+#include "vyassetloader.h"
+#include "vyresourcetable.h"
+#include "vydamage.h"
+#include "vycamera.h"
+#include "vyactionqueue.h"
+
+class VyTextureAtlas;
+class VyAtlasSprite;
+class VySpriteBatch;
+class VyGlyphCache;
+class VyFontCache;
+class VyRenderQueue;
+class VyPrimitiveBatch;
+class VyCircleCache;
+class VyFrameArena;
+class VyJobSystem;
+class VyInputRecorder;
+class VyInputReplay;
+class SelectableRect;
 
 class VyEngine
 {
@@ -26,78 +49,331 @@ public:
 		UnsupportedFormat = 5,
 		MissingResource = 6,
 	};
-	enum class Renderer { None = 0, SDL_Surface = 1, SDL_Renderer = 2 };
+	/// <summary>
+	/// SDL_Surface and SDL_Renderer draw to a window. Offscreen has no window: it draws into a memory surface through the software renderer,
+	/// for rendering on machines without a display. nothing is presented or waited for, read the frame back with <see cref="VyEngine::ReadPixels"/>
+	/// </summary>
+	enum class Renderer { None = 0, SDL_Surface = 1, SDL_Renderer = 2, Offscreen = 3 };
 
-	typedef std::function<void(SDL_Event)> EventDelegate;
+	typedef VyDelegateTable::Delegate EventDelegate;
 	typedef std::map<size_t, EventDelegate> EventDelegateKeyedList;
-	typedef std::map<int, EventDelegateKeyedList> EventDelegateListMap;
 	typedef std::function<void()> TriggeredEvent;
 	typedef std::map<size_t, TriggeredEvent> EventKeyedList;
+	typedef VyResourceHandle TextureHandle;
+	typedef VyActionQueue::Action DeferredAction;
+	typedef VyActionQueue::Phase Phase;
+	/// <summary>a font name and size, from <see cref="VyEngine::RegisterFont"/></summary>
+	typedef int FontId;
 	static VyEngine* GetInstance() { return _instance; }
 private:
 	TTF_Font* _currentFont;
-	std::string _currentFontId;
-	std::string _currentFontName;
-	int _currentFontSize;
+	/// <summary>pinned in _fontCache while current</summary>
+	FontId _currentFontId;
 	static VyEngine* _instance;
 	SDL_Window* _window = NULL;
 	SDL_Surface* _screenSurface = NULL;
 	SDL_Renderer* _renderer = NULL;
 	int _width, _height;
 	Renderer _rendererKind;
-	EventDelegateListMap _keyBindDown;
-	EventDelegateListMap _keyBindUp;
-	EventDelegateListMap _mouseBindDown;
-	EventDelegateListMap _mouseBindUp;
-	int _isPressedKeyMask[8];
-	int _isPressedKeyMaskScancode[16];
-	int _isMousePressed[1];
+	VyDelegateTable _keyBindDown;
+	VyDelegateTable _keyBindUp;
+	VyDelegateTable _mouseBindDown;
+	VyDelegateTable _mouseBindUp;
+	/// <summary>published by ProcessInput, read-only until the next ProcessInput</summary>
+	VyInputSnapshot _input;
+	/// <summary>collects events for the next snapshot</summary>
+	VyInputSnapshot _inputNext;
 	bool _running;
 	bool _initialized;
 	std::vector<SDL_Surface*> _managedSurfaces;
-	std::vector<size_t> _managedTextures;
-	std::map<std::string, TTF_Font*> _fonts;
-	std::vector<VyEventProcessor*> _eventProcessors;
+	/// <summary>every texture the engine created, reference counted. image textures are keyed by path so loading one twice shares it</summary>
+	VyResourceTable<SDL_Texture*> _textures;
+	/// <summary>for the SDL_Texture* API: <see cref="VyEngine::ReleaseSdlTexture"/></summary>
+	std::unordered_map<SDL_Texture*, TextureHandle> _textureHandles;
+	VyTextureAtlas* _atlas;
+	VySpriteBatch* _spriteBatch;
+	VyRenderQueue* _renderQueue;
+	VyPrimitiveBatch* _primitiveBatch;
+	/// <summary>keyed by font, whose TTF_Font stays pinned in _fontCache while the glyph cache exists</summary>
+	std::map<FontId, VyGlyphCache*> _glyphCaches;
+	VyCircleCache* _circleCache;
+	VyFontCache* _fontCache;
+	VyFrameArena* _frameArena;
+	VyAssetLoader* _assetLoader;
+	/// <summary>per VyEventProcessor::EventCategory, the processors subscribed to it</summary>
+	std::vector<VyEventProcessor*> _eventProcessors[(int)VyEventProcessor::EventCategory::Count];
+	/// <summary>nesting of ProcessEvent. while above 0, UnregisterProcessor leaves NULL in _eventProcessors, erased once dispatch ends</summary>
+	int _processorDispatchDepth;
+	bool _processorsRemoved;
 	std::vector<VyDrawable*> _drawables;
+	/// <summary>for each drawable, the screen bounds it had when last drawn with damage tracking</summary>
+	std::vector<SDL_Rect> _drawnBounds;
+	/// <summary>the drawables RenderDamage didn't cull this frame</summary>
+	std::vector<VyDrawable*> _visibleDrawables;
+	VyDamageRegion _damage;
+	VyCamera _camera;
+	/// <summary>camera version the screen was last drawn with: any other means everything on screen moved</summary>
+	Uint32 _drawnCameraVersion;
+	/// <summary>the damage drawn this frame, presented with SDL_UpdateWindowSurfaceRects</summary>
+	std::vector<SDL_Rect> _presentRects;
 	std::vector<VyUpdatable*> _updatable;
-	class DelegateNextFrame {
-	public:
-		std::string src;
-		TriggeredEvent action;
-	};
-	typedef std::vector<DelegateNextFrame> DelegateList;
-	typedef std::shared_ptr<std::vector<DelegateNextFrame>> DelegateListPtr;
-	DelegateListPtr _todo;
-	DelegateListPtr _todoNow;
+	/// <summary>_updatable split by IsParallelSafe, every ProcessUpdatables that uses the job system</summary>
+	std::vector<VyUpdatable*> _parallelUpdatable;
+	std::vector<VyUpdatable*> _serialUpdatable;
+	VyJobSystem* _jobs;
+	VyActionQueue _actions;
+	VyInputRecorder* _recorder;
+	VyInputReplay* _replay;
+	/// <summary>the next frame of _replay to feed</summary>
+	int _replayFrame;
+	/// <summary>fixed updates the last replayed frame ran when it was recorded</summary>
+	int _replaySteps;
+	/// <summary>a run of mouse motion being merged, with <see cref="VyEngine::CoalesceMouseMotion"/></summary>
+	SDL_Event _pendingMotion;
+	bool _hasPendingMotion;
+	int _coalescedMotion;
+	VyHitTestGrid _hitTest;
+	VyPointerTarget* _hoveredTarget;
+	VyPointerTarget* _focusedTarget;
+	/// <summary>the one selected rect, whether selected by keys or a click. not owned</summary>
+	SelectableRect* _selection;
+	/// <summary>target that received the mouse down, per button, so it also gets the mouse up</summary>
+	VyPointerTarget* _capturedTarget[8];
+	Uint32 _hoverVersion;
+	Coord _hoverPosition;
+	double _interpolationAlpha;
+	double _frameWorkTime;
 public:
 	std::string ErrorMessage;
 	Coord MousePosition;
 	int MouseClickState;
+	/// <summary>
+	/// passed to SDL_CreateWindow by <see cref="VyEngine::Init"/>. set before Init. unused with Renderer::Offscreen
+	/// </summary>
+	Uint32 WindowFlags;
+	/// <summary>
+	/// passed to SDL_CreateRenderer by <see cref="VyEngine::Init"/>. use SDL_RENDERER_SOFTWARE when running headless.
+	/// </summary>
+	Uint32 RendererFlags;
+	/// <summary>
+	/// seconds of simulation advanced by each <see cref="VyEngine::Update"/> during <see cref="VyEngine::Run"/>, which fails unless it is above 0
+	/// </summary>
+	double FixedTimestep;
+	/// <summary>
+	/// seconds per rendered frame that <see cref="VyEngine::Run"/> paces to. 0 to render as fast as possible, as Renderer::Offscreen always does
+	/// </summary>
+	double TargetFrameTime;
+	/// <summary>
+	/// most fixed updates <see cref="VyEngine::Run"/> will run in one frame. time beyond that is dropped, so a slow frame cannot spiral
+	/// </summary>
+	int MaxCatchUpSteps;
+	/// <summary>
+	/// seconds per frame <see cref="VyEngine::Run"/> spends finishing async loads (texture uploads, font opens). at least one asset is finished per frame
+	/// </summary>
+	double AssetUploadBudget;
+	/// <summary>
+	/// <see cref="VyEngine::Render"/> has drawables record into the <see cref="VyRenderQueue"/>, then draws it sorted and merged.
+	/// only with Renderer::SDL_Renderer or Renderer::Offscreen
+	/// </summary>
+	bool UseRenderQueue;
+	/// <summary>
+	/// with Renderer::SDL_Surface, only the parts of the screen that changed are cleared, redrawn and presented.
+	/// drawables must report changes that keep their bounds with <see cref="VyEngine::AddDamage"/>; anything drawn by Run's onDraw must too
+	/// </summary>
+	bool UseDamageTracking;
+	/// <summary>
+	/// <see cref="VyEngine::ProcessUpdatables"/> runs updatables that are <see cref="VyUpdatable::IsParallelSafe"/> across every core first,
+	/// in no particular order, then the rest in order on the calling thread
+	/// </summary>
+	bool UseParallelUpdate;
+	/// <summary>
+	/// parallel-safe updatables per job with <see cref="VyEngine::UseParallelUpdate"/>. bigger chunks cost less to hand out, smaller ones balance better
+	/// </summary>
+	int ParallelUpdateChunk;
+	/// <summary>
+	/// <see cref="VyEngine::Render"/> skips drawables whose <see cref="VyDrawable::GetDrawBounds"/> are outside the camera's view
+	/// </summary>
+	bool UseCulling;
+	/// <summary>
+	/// <see cref="VyEngine::ProcessInput"/> merges each run of consecutive mouse motion events into one, with the last position and the summed motion
+	/// </summary>
+	bool CoalesceMouseMotion;
 	VyEngine(int width, int height);
 	~VyEngine();
 	void FailFast();
 	ErrorCode Init(std::string windowName, Renderer renderer);
 	ErrorCode Release();
 	bool IsRunning();
+	/// <returns>the window surface, or with Renderer::Offscreen the memory surface, holding the last frame after <see cref="VyEngine::Render"/></returns>
 	SDL_Surface* GetScreenSurface();
 	SDL_Renderer* GetRenderer();
 	TTF_Font* GetFont();
 	std::string GetFontName();
-	std::string GetFontId();
+	/// <returns>-1 without a current font</returns>
+	FontId GetFontId();
 	int GetFontSize();
+	/// <summary>
+	/// the id for font/fontName.ttf at this size, without opening it. keep the id to switch fonts without any string work
+	/// </summary>
+	FontId RegisterFont(std::string fontName, int size);
 	VyEngine::ErrorCode SetFont(std::string fontName, int size);
+	/// <summary>
+	/// makes the font current, opening it from the cached file if it was closed or evicted
+	/// </summary>
+	VyEngine::ErrorCode SetFont(FontId font);
+	/// <summary>
+	/// every font file is read once and shared by all of its sizes, within a memory budget
+	/// </summary>
+	VyFontCache* GetFontCache();
+	/// <summary>
+	/// scratch memory for the current frame, reset at the start of every <see cref="VyEngine::ProcessInput"/>
+	/// </summary>
+	VyFrameArena* GetFrameArena();
 	void ClearGraphics();
 	void Render();
 	void ProcessInput();
+	/// <summary>
+	/// <see cref="VyEngine::ProcessUpdatables"/> then <see cref="VyEngine::ServiceQueue"/>
+	/// </summary>
 	void Update();
+	void ProcessUpdatables();
+	/// <summary>
+	/// the worker threads behind <see cref="VyEngine::UseParallelUpdate"/>, started on first use
+	/// </summary>
+	VyJobSystem* GetJobSystem();
+	/// <summary>
+	/// engine-owned frame loop, until <see cref="VyEngine::IsRunning"/> is false or an error is set:
+	/// ProcessInput, fixed-timestep Update (0 to MaxCatchUpSteps times), ClearGraphics, onDraw, Render, then wait for the frame deadline
+	/// </summary>
+	/// <param name="onDraw">immediate-mode drawing before registered drawables. may be NULL</param>
+	VyEngine::ErrorCode Run(TriggeredEvent onDraw);
+	/// <summary>
+	/// how far between the last and next fixed update the current render is, from 0 to 1. valid during <see cref="VyEngine::Run"/>
+	/// </summary>
+	double GetInterpolationAlpha() const;
+	/// <summary>
+	/// seconds the last <see cref="VyEngine::Run"/> frame spent working, not counting the wait for the frame deadline
+	/// </summary>
+	double GetFrameWorkTime() const;
+	/// <summary>
+	/// writes every event <see cref="VyEngine::ProcessInput"/> takes from SDL to path, from the next frame until StopRecording,
+	/// with the number of fixed updates <see cref="VyEngine::Run"/> ran each frame
+	/// </summary>
+	VyEngine::ErrorCode StartRecording(std::string path);
+	VyEngine::ErrorCode StopRecording();
+	bool IsRecording() const;
+	/// <summary>
+	/// feeds a recording back through <see cref="VyEngine::ProcessEvent"/>, one recorded frame per ProcessInput, instead of live input (except SDL_QUIT).
+	/// <see cref="VyEngine::Run"/> then runs each frame's recorded updates without waiting for the clock, and returns when the recording ends
+	/// </summary>
+	VyEngine::ErrorCode StartReplay(std::string path);
+	void StopReplay();
+	bool IsReplaying() const;
+	/// <summary>
+	/// fixed updates the frame just replayed ran when it was recorded, for frame loops other than Run
+	/// </summary>
+	int GetReplaySteps() const { return _replaySteps; }
+	/// <summary>
+	/// the state as of the last event processed, so inside a key or mouse delegate it includes that event.
+	/// for a whole frame's consistent state, prefer <see cref="VyEngine::GetInput"/>, which also doesn't decode sdlk or return an error
+	/// </summary>
+	/// <param name="sdlk">keycode, or SDL_MOUSE_MAINCLICK etc</param>
 	VyEngine::ErrorCode IsPressed(int sdlk, bool& out_pressed);
+	/// <summary>
+	/// input state as of the last <see cref="VyEngine::ProcessInput"/>, with this frame's pressed/released edges
+	/// </summary>
+	const VyInputSnapshot& GetInput() const { return _input; }
 	VyEngine::ErrorCode LoadSdlSurfaceBasic(std::string path, SDL_Surface*& out_surface);
 	VyEngine::ErrorCode LoadSdlTextBasic(std::string text, SDL_Surface*& out_surface);
 	VyEngine::ErrorCode LoadSdlSurface(std::string path, SDL_Surface*& out_surface);
 	VyEngine::ErrorCode LoadSdlTexture(std::string path, SDL_Texture*& out_texture);
 	VyEngine::ErrorCode LoadSdlTexture(SDL_Surface* loadedSurface, SDL_Texture*& out_texture);
 	VyEngine::ErrorCode CreateText(std::string text, SDL_Texture*& out_texture);
+	/// <summary>
+	/// like <see cref="VyEngine::LoadSdlSurface"/>, but decoded and converted on a worker thread.
+	/// the surface is managed by the engine once the handle is ready
+	/// </summary>
+	VyAssetHandle LoadSdlSurfaceAsync(std::string path);
+	/// <summary>
+	/// like <see cref="VyEngine::LoadSdlTexture"/>, but decoded on a worker thread. only the upload happens on the main thread, in <see cref="VyEngine::ProcessAssetUploads"/>.
+	/// a ready handle holds a texture reference, dropped with <see cref="VyEngine::ReleaseSdlTexture"/>
+	/// </summary>
+	VyAssetHandle LoadSdlTextureAsync(std::string path);
+	/// <summary>
+	/// like <see cref="VyEngine::SetFont"/>, but the file is read on a worker thread. the font becomes current when the handle is ready.
+	/// the handle's font may be closed by the font cache once it is no longer current
+	/// </summary>
+	VyAssetHandle SetFontAsync(std::string fontName, int size);
+	/// <summary>
+	/// finishes decoded async loads on this (the render) thread until budgetSeconds pass. called by <see cref="VyEngine::Run"/> every frame
+	/// </summary>
+	void ProcessAssetUploads(double budgetSeconds);
+	/// <summary>
+	/// blocks until the async load is done, finishing other decoded loads meanwhile. main thread only
+	/// </summary>
+	VyEngine::ErrorCode WaitForAsset(const VyAssetHandle& handle);
+	/// <summary>
+	/// loads an image into the engine's <see cref="VyTextureAtlas"/> instead of its own texture, so it can be drawn with <see cref="VyEngine::GetSpriteBatch"/>
+	/// </summary>
+	VyEngine::ErrorCode LoadAtlasSprite(std::string path, VyAtlasSprite& out_sprite);
+	VyEngine::ErrorCode LoadAtlasSprite(SDL_Surface* loadedSurface, VyAtlasSprite& out_sprite);
+	/// <returns>NULL unless initialized with Renderer::SDL_Renderer or Renderer::Offscreen</returns>
+	VyTextureAtlas* GetAtlas();
+	/// <summary>
+	/// shared batch for atlas sprites, flushed by <see cref="VyEngine::Render"/> after the drawables.
+	/// drawables that mix batched sprites with direct renderer calls must flush it first
+	/// </summary>
+	/// <returns>NULL unless initialized with Renderer::SDL_Renderer or Renderer::Offscreen</returns>
+	VySpriteBatch* GetSpriteBatch();
+	/// <returns>NULL unless initialized with Renderer::SDL_Renderer or Renderer::Offscreen</returns>
+	VyRenderQueue* GetRenderQueue();
+	/// <summary>
+	/// shared batch for rects, points and lines, flushed by <see cref="VyEngine::Render"/> after the drawables, so it suits overlays
+	/// </summary>
+	/// <returns>NULL before Init</returns>
+	VyPrimitiveBatch* GetPrimitiveBatch();
+	/// <summary>
+	/// the view <see cref="VyEngine::Render"/> draws through, and culls against. pointer targets are hit in its world coordinates,
+	/// while <see cref="VyEngine::MousePosition"/> stays in screen coordinates
+	/// </summary>
+	VyCamera* GetCamera() { return &_camera; }
+	/// <summary>
+	/// marks part of the world to be redrawn next Render, with <see cref="VyEngine::UseDamageTracking"/>. ignored otherwise
+	/// </summary>
+	void AddDamage(const SDL_Rect& rect);
+	void DamageAll();
+	/// <summary>
+	/// glyphs of the current font, in the engine's atlas, for text that changes often
+	/// </summary>
+	/// <returns>NULL without a current font, or unless initialized with Renderer::SDL_Renderer or Renderer::Offscreen</returns>
+	VyGlyphCache* GetGlyphCache();
+	/// <summary>
+	/// circle sprites in the engine's atlas, for drawing many circles of a few sizes through <see cref="VyEngine::GetSpriteBatch"/>
+	/// </summary>
+	/// <returns>NULL unless initialized with Renderer::SDL_Renderer or Renderer::Offscreen</returns>
+	VyCircleCache* GetCircleCache();
+	/// <summary>
+	/// drops one reference to a texture from LoadSdlTexture/CreateText/LoadSdlTextureAsync, destroying it with the last one.
+	/// don't use the texture after releasing it
+	/// </summary>
 	void ReleaseSdlTexture(SDL_Texture* texture);
+	/// <summary>
+	/// copies what was last rendered into a new ARGB8888 surface, freed by the caller with SDL_FreeSurface
+	/// </summary>
+	/// <param name="area">in screen coordinates, NULL for the whole screen</param>
+	VyEngine::ErrorCode ReadPixels(SDL_Surface*& out_surface, const SDL_Rect* area = NULL);
+	/// <summary>
+	/// what was last rendered, as a png
+	/// </summary>
+	VyEngine::ErrorCode SaveScreenshot(std::string path);
+	/// <summary>
+	/// loads the image, or shares it if already loaded, and adds a reference
+	/// </summary>
+	VyEngine::ErrorCode AcquireTexture(std::string path, TextureHandle& out_handle);
+	/// <returns>NULL if the handle has been released</returns>
+	SDL_Texture* GetTexture(TextureHandle handle) const;
+	void ReleaseTexture(TextureHandle handle);
+	int GetLiveTextureCount() const { return _textures.GetLiveCount(); }
 	Coord GetTextureSize(SDL_Texture* texture);
 	/// <summary>
 	/// this is set by <see cref="VyEngine::ProcessInput"/>
@@ -115,20 +391,89 @@ public:
 	void UnregisterMouseUp(int button, size_t owner);
 	void UnregisterKeyDown(int button, size_t owner);
 	void UnregisterKeyUp(int button, size_t owner);
+	/// <summary>
+	/// the processor gets only the events of its <see cref="VyEventProcessor::GetEventMask"/>, as it is now
+	/// </summary>
 	void RegisterProcessor(VyEventProcessor* eventProcessor);
+	/// <summary>
+	/// safe from inside HandleEvent: the processor gets no more events, and the ones after it still get this one
+	/// </summary>
 	void UnregisterProcessor(VyEventProcessor* eventProcessor);
+	/// <summary>
+	/// subscribes a registered processor again with what its GetEventMask returns now, e.g. from a subclass constructor that widens the mask
+	/// </summary>
+	void UpdateEventMask(VyEventProcessor* eventProcessor);
 	void RegisterDrawable(VyDrawable* drawable);
 	void UnregisterDrawable(VyDrawable* drawable);
 	void RegisterUpdatable(VyUpdatable* updatable);
 	void UnregisterUpdatable(VyUpdatable* updatable);
+	/// <summary>
+	/// mouse buttons are routed only to the topmost target under the mouse (and its parents), found through a spatial grid.
+	/// call <see cref="VyEngine::MovePointerTarget"/> whenever the target's rect changes
+	/// </summary>
+	void RegisterPointerTarget(VyPointerTarget* target, const Rect& rect);
+	void MovePointerTarget(VyPointerTarget* target, const Rect& rect);
+	void SetPointerTargetActive(VyPointerTarget* target, bool active);
+	void UnregisterPointerTarget(VyPointerTarget* target);
+	VyPointerTarget* GetHoveredTarget() const { return _hoveredTarget; }
+	/// <summary>
+	/// the selected rect, kept by <see cref="SelectableRect::SetSelected"/>. a left click unselects it before focusing what was clicked
+	/// </summary>
+	SelectableRect* GetSelection() const { return _selection; }
+	void SetSelection(SelectableRect* rect) { _selection = rect; }
 	void ProcessEvent(const SDL_Event& e);
+	/// <summary>
+	/// runs the actions queued for <see cref="VyActionQueue::Phase::Update"/>
+	/// </summary>
 	void ServiceQueue();
-	void Queue(TriggeredEvent action, std::string src);
-	static void ProcessDelegates(VyEngine::EventDelegateListMap& delegates, int id, const SDL_Event& e);
+	/// <summary>
+	/// runs the actions queued for phase. <see cref="VyEngine::Run"/> (through ProcessInput, Update and Render) services every phase once per frame
+	/// </summary>
+	/// <returns>how many actions ran</returns>
+	int ServicePhase(Phase phase);
+	/// <summary>
+	/// runs action later in the frame: by default in the next <see cref="VyEngine::ServiceQueue"/>, after every updatable.
+	/// safe to call from any thread, including parallel updatables
+	/// </summary>
+	/// <param name="source">where it was queued from, for the profiler: <see cref="VY_HERE"/></param>
+	void Queue(DeferredAction action, VySourceLocation source, Phase phase = Phase::Update);
+	static void ProcessDelegates(VyDelegateTable& delegates, int id, const SDL_Event& e);
 	static void ProcessDelegates(VyEngine::EventDelegateKeyedList& delegates, const SDL_Event& e);
 	static void ProcessDelegates(VyEngine::EventKeyedList& delegates);
-	static void ProcessDelegates(std::vector<VyEventProcessor*> eventProcessors, const SDL_Event& e);
+	/// <summary>
+	/// skips NULL entries, and processors added during the call
+	/// </summary>
+	static void ProcessDelegates(const std::vector<VyEventProcessor*>& eventProcessors, const SDL_Event& e);
 private:
 	VyEngine::ErrorCode InitSDL_Surface();
+	VyEngine::ErrorCode InitOffscreen();
 	VyEngine::ErrorCode InitSDL_Renderer();
+	VyEngine::ErrorCode DecodeInputCode(int sdlk, bool& out_isMouse, int& out_index);
+	static void WaitUntil(Uint64 deadline);
+	/// <summary>
+	/// next happened right after into: into takes its position and button state, and adds its motion
+	/// </summary>
+	static void CoalesceMotion(SDL_Event& into, const SDL_Event& next);
+	/// <summary>
+	/// ProcessEvent, or merged into the pending motion
+	/// </summary>
+	void ConsumeEvent(const SDL_Event& e);
+	void ReplayFrame();
+	VyAssetLoader* GetAssetLoader();
+	void FinishAsset(VyAssetRequest& request);
+	void FlushRenderQueue();
+	/// <summary>
+	/// the camera's offset for the batches and render queue, so drawables add to them in world coordinates
+	/// </summary>
+	void SetDrawOffset(const Coord& offset);
+	/// <summary>
+	/// draws what drawables left in the sprite and primitive batches
+	/// </summary>
+	void FlushBatches();
+	void RenderDamage(SDL_Renderer* g);
+	TextureHandle ManageTexture(SDL_Texture* texture, const std::string& key);
+	static std::string TextureKey(const std::string& path);
+	void UpdateHover();
+	void ProcessPointerButton(const SDL_Event& e);
+	static void DeliverPointerEvent(VyPointerTarget* target, const SDL_Event& e);
 };
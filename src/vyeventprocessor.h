@@ -2,20 +2,65 @@
 
 #include <SDL.h>
 #include <string>
+#include "coord.h"
+
+class VyRenderQueue;
+class HasRect;
 
 class VyEventProcessor {
 public:
+	/// <summary>
+	/// kinds of SDL event a processor can subscribe to, as bits of <see cref="VyEventProcessor::GetEventMask"/>
+	/// </summary>
+	enum class EventCategory { Keyboard, TextInput, MouseMotion, MouseButton, MouseWheel, Window, Other, Count };
+	static Uint32 Mask(EventCategory category) { return 1u << (int)category; }
+	static Uint32 AllEvents() { return (1u << (int)EventCategory::Count) - 1; }
+	static EventCategory GetCategory(Uint32 eventType) {
+		switch (eventType) {
+		case SDL_KEYDOWN: case SDL_KEYUP: return EventCategory::Keyboard;
+		case SDL_TEXTINPUT: case SDL_TEXTEDITING: return EventCategory::TextInput;
+		case SDL_MOUSEMOTION: return EventCategory::MouseMotion;
+		case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP: return EventCategory::MouseButton;
+		case SDL_MOUSEWHEEL: return EventCategory::MouseWheel;
+		case SDL_WINDOWEVENT: return EventCategory::Window;
+		default: return EventCategory::Other;
+		}
+	}
 	virtual void HandleEvent(const SDL_Event& e) = 0;
+	/// <summary>
+	/// the categories HandleEvent gets from the engine, as Mask bits. read by <see cref="VyEngine::RegisterProcessor"/>; call <see cref="VyEngine::UpdateEventMask"/> when it changes
+	/// </summary>
+	virtual Uint32 GetEventMask() const { return AllEvents(); }
 };
 
 class VyDrawable {
 public:
-	virtual void Draw(SDL_Renderer* g) = 0;
+	/// <summary>
+	/// in world coordinates: the engine's batches follow the camera by themselves, direct renderer calls add offset, the camera's pan
+	/// </summary>
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) = 0;
+	/// <summary>
+	/// adds draw commands to the queue instead of drawing, when <see cref="VyEngine::UseRenderQueue"/> is set
+	/// </summary>
+	/// <returns>false to be drawn with Draw instead, after whatever was queued before it is flushed</returns>
+	virtual bool Record(VyRenderQueue& queue) { return false; }
+	/// <summary>
+	/// the area Draw touches, in world coordinates (the screen's until the <see cref="VyCamera"/> moves). a drawable outside the camera's view isn't drawn.
+	/// with <see cref="VyEngine::UseDamageTracking"/>, a drawable whose bounds change is redrawn without reporting damage,
+	/// and one outside the damage isn't drawn at all
+	/// </summary>
+	/// <returns>false if unknown: the drawable is drawn wherever there is damage</returns>
+	virtual bool GetDrawBounds(SDL_Rect& out_bounds) { return false; }
 };
 
 class VyUpdatable {
 public:
 	virtual void Update() = 0;
+	/// <summary>
+	/// with <see cref="VyEngine::UseParallelUpdate"/>, parallel-safe updatables run on worker threads, at the same time as each other.
+	/// only say yes if Update touches nothing but this object's own state, and defers everything else with <see cref="VyEngine::Queue"/>
+	/// </summary>
+	virtual bool IsParallelSafe() const { return false; }
 };
 
 class VyInterface {
@@ -25,4 +70,5 @@ public:
 	virtual VyEventProcessor* AsEventProcessor() = 0;
 	virtual VyDrawable* AsDrawable() = 0;
 	virtual VyUpdatable* AsUpdatable() = 0;
+	virtual HasRect* AsRect() = 0;
 };
@@ -0,0 +1,159 @@
+#include "vyfontcache.h"
+#include "stringstuff.h"
+
+VyFontCache::VyFontCache(std::string directory, size_t budgetBytes) : _directory(directory), _budget(budgetBytes), _usedBytes(0) {}
+
+VyFontCache::~VyFontCache() {
+	Clear();
+}
+
+size_t VyFontCache::EstimateFontBytes(int size) {
+	return 32 * 1024 + (size_t)size * size * 96;
+}
+
+VyFontCache::FontId VyFontCache::GetId(const std::string& name, int size) {
+	std::string key = name;
+	key += ':';
+	key += std::to_string(size);
+	auto found = _ids.find(key);
+	if (found != _ids.end()) {
+		return found->second;
+	}
+	int file;
+	auto foundFile = _fileIds.find(name);
+	if (foundFile != _fileIds.end()) {
+		file = foundFile->second;
+	} else {
+		file = (int)_files.size();
+		_files.push_back({ name, NULL, 0, 0 });
+		_fileIds[name] = file;
+	}
+	FontId id = (FontId)_entries.size();
+	_entries.push_back({ file, size, NULL, 0, 0, _lru.end() });
+	_ids[key] = id;
+	return id;
+}
+
+bool VyFontCache::IsFileLoaded(const std::string& name) const {
+	auto found = _fileIds.find(name);
+	return found != _fileIds.end() && _files[found->second].data != NULL;
+}
+
+bool VyFontCache::AdoptFile(const std::string& name, void* data, size_t size) {
+	auto found = _fileIds.find(name);
+	int file;
+	if (found != _fileIds.end()) {
+		file = found->second;
+		if (_files[file].data != NULL) { return false; }
+	} else {
+		file = (int)_files.size();
+		_files.push_back({ name, NULL, 0, 0 });
+		_fileIds[name] = file;
+	}
+	_files[file].data = data;
+	_files[file].size = size;
+	_usedBytes += size;
+	Evict(NoFont);
+	return true;
+}
+
+VyEngine::ErrorCode VyFontCache::LoadFile(int file) {
+	FontFile& fontFile = _files[file];
+	std::string path = _directory + fontFile.name + ".ttf";
+	fontFile.data = SDL_LoadFile(path.c_str(), &fontFile.size);
+	if (fontFile.data == NULL) {
+		VyEngine::GetInstance()->ErrorMessage = string_format("could not load %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+		return VyEngine::ErrorCode::MissingResource;
+	}
+	_usedBytes += fontFile.size;
+	++_stats.fileReads;
+	return VyEngine::ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyFontCache::Open(FontId id, TTF_Font*& out_font) {
+	Entry& entry = _entries[id];
+	if (entry.font != NULL) {
+		++_stats.hits;
+		_lru.splice(_lru.begin(), _lru, entry.lru);
+		out_font = entry.font;
+		return VyEngine::ErrorCode::Success;
+	}
+	++_stats.misses;
+	FontFile& file = _files[entry.file];
+	if (file.data == NULL) {
+		VyEngine::ErrorCode err = LoadFile(entry.file);
+		if (err != VyEngine::ErrorCode::Success) { return err; }
+	}
+	// each size reads through its own RWops over the one shared copy of the file
+	entry.font = TTF_OpenFontRW(SDL_RWFromConstMem(file.data, (int)file.size), 1, entry.size);
+	if (entry.font == NULL) {
+		VyEngine::GetInstance()->ErrorMessage = string_format("could not open %s at size %d! SDL Error: %s\n", file.name.c_str(), entry.size, TTF_GetError());
+		return VyEngine::ErrorCode::MissingResource;
+	}
+	++file.openFonts;
+	entry.bytes = EstimateFontBytes(entry.size);
+	_usedBytes += entry.bytes;
+	_lru.push_front(id);
+	entry.lru = _lru.begin();
+	Evict(id);
+	out_font = entry.font;
+	return VyEngine::ErrorCode::Success;
+}
+
+void VyFontCache::Close(FontId id) {
+	Entry& entry = _entries[id];
+	TTF_CloseFont(entry.font);
+	entry.font = NULL;
+	_usedBytes -= entry.bytes;
+	entry.bytes = 0;
+	_lru.erase(entry.lru);
+	entry.lru = _lru.end();
+	--_files[entry.file].openFonts;
+}
+
+void VyFontCache::FreeFile(int file) {
+	FontFile& fontFile = _files[file];
+	SDL_free(fontFile.data);
+	fontFile.data = NULL;
+	_usedBytes -= fontFile.size;
+	fontFile.size = 0;
+}
+
+void VyFontCache::Evict(FontId keep) {
+	auto it = _lru.end();
+	while (_usedBytes > _budget && it != _lru.begin()) {
+		--it;
+		FontId id = *it;
+		if (id == keep || _entries[id].pins > 0) { continue; }
+		int file = _entries[id].file;
+		// Close erases it from the list: continue from its already visited neighbor
+		auto next = it;
+		++next;
+		Close(id);
+		it = next;
+		++_stats.evictions;
+		if (_files[file].openFonts == 0 && _usedBytes > _budget) {
+			FreeFile(file);
+		}
+	}
+	// files without any open size are the cheapest to drop
+	for (int file = 0; file < _files.size() && _usedBytes > _budget; ++file) {
+		if (_files[file].data != NULL && _files[file].openFonts == 0) {
+			FreeFile(file);
+		}
+	}
+}
+
+void VyFontCache::Clear() {
+	for (int id = 0; id < _entries.size(); ++id) {
+		if (_entries[id].font != NULL) {
+			Close(id);
+		}
+		_entries[id].pins = 0;
+	}
+	for (int file = 0; file < _files.size(); ++file) {
+		if (_files[file].data != NULL) {
+			FreeFile(file);
+		}
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include "vyengine.h"
+
+/// <summary>
+/// opens fonts by (name, size) from one in-memory copy of each .ttf, with an LRU memory budget.
+/// a name and size are turned into an integer <see cref="VyFontCache::FontId"/> once; after that, lookups are array indexing.
+/// fonts that aren't pinned may be closed when over budget, so only hold a TTF_Font* while its id is pinned
+/// </summary>
+class VyFontCache {
+public:
+	typedef int FontId;
+	static const FontId NoFont = -1;
+	class Stats {
+	public:
+		int hits;
+		int misses;
+		int evictions;
+		int fileReads;
+		Stats() : hits(0), misses(0), evictions(0), fileReads(0) {}
+	};
+private:
+	struct FontFile {
+		std::string name;
+		void* data;
+		size_t size;
+		int openFonts;
+	};
+	struct Entry {
+		int file;
+		int size;
+		TTF_Font* font;
+		size_t bytes;
+		int pins;
+		std::list<FontId>::iterator lru;
+	};
+	std::string _directory;
+	size_t _budget;
+	size_t _usedBytes;
+	std::vector<FontFile> _files;
+	std::unordered_map<std::string, int> _fileIds;
+	std::vector<Entry> _entries;
+	std::unordered_map<std::string, FontId> _ids;
+	/// <summary>open fonts, most recently used first</summary>
+	std::list<FontId> _lru;
+	Stats _stats;
+public:
+	/// <param name="directory">where "name.ttf" files are, with a trailing slash</param>
+	/// <param name="budgetBytes">font files in memory plus an estimate for each open size</param>
+	VyFontCache(std::string directory = "font/", size_t budgetBytes = 8 * 1024 * 1024);
+	~VyFontCache();
+	/// <summary>
+	/// the id for this name and size, the same every call. doesn't open anything
+	/// </summary>
+	FontId GetId(const std::string& name, int size);
+	/// <summary>
+	/// opens the font if it isn't open, reading its file if needed, and marks it most recently used
+	/// </summary>
+	VyEngine::ErrorCode Open(FontId id, TTF_Font*& out_font);
+	bool IsOpen(FontId id) const { return _entries[id].font != NULL; }
+	bool IsFileLoaded(const std::string& name) const;
+	/// <summary>
+	/// gives the cache a file already read elsewhere (like on a loader thread). data must come from SDL_malloc/SDL_LoadFile
+	/// </summary>
+	/// <returns>false if the file was already loaded: data still belongs to the caller</returns>
+	bool AdoptFile(const std::string& name, void* data, size_t size);
+	const std::string& GetName(FontId id) const { return _files[_entries[id].file].name; }
+	int GetSize(FontId id) const { return _entries[id].size; }
+	/// <summary>
+	/// keeps the font open regardless of budget, until unpinned as many times
+	/// </summary>
+	void Pin(FontId id) { ++_entries[id].pins; }
+	void Unpin(FontId id) { --_entries[id].pins; Evict(NoFont); }
+	void SetBudget(size_t budgetBytes) { _budget = budgetBytes; Evict(NoFont); }
+	size_t GetBudget() const { return _budget; }
+	size_t GetUsedBytes() const { return _usedBytes; }
+	const Stats& GetStats() const { return _stats; }
+	void ResetStats() { _stats = Stats(); }
+	/// <summary>
+	/// closes every font and frees every file, pinned or not. ids stay valid
+	/// </summary>
+	void Clear();
+private:
+	/// <summary>
+	/// guess of what SDL_ttf holds for one open size (face, metrics, cached glyph bitmaps). it doesn't report the real number
+	/// </summary>
+	static size_t EstimateFontBytes(int size);
+	VyEngine::ErrorCode LoadFile(int file);
+	void Close(FontId id);
+	void FreeFile(int file);
+	/// <summary>
+	/// closes least recently used unpinned fonts, and files no font uses, until under budget
+	/// </summary>
+	void Evict(FontId keep);
+};
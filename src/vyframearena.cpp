@@ -0,0 +1,46 @@
+#include "vyframearena.h"
+
+VyFrameArena::VyFrameArena(size_t blockSize) : _blocks(), _current(-1), _used(0), _blockSize(blockSize), _destructors(), _allocatedThisFrame(0), _peak(0) {}
+
+VyFrameArena::~VyFrameArena() {
+	Reset();
+}
+
+void* VyFrameArena::Allocate(size_t bytes, size_t align) {
+	size_t start = (_used + align - 1) & ~(align - 1);
+	while (_current < 0 || start + bytes > _blocks[_current].size) {
+		// the next kept block, if it is big enough, otherwise a new one
+		++_current;
+		if (_current == _blocks.size() || _blocks[_current].size < bytes) {
+			size_t size = bytes > _blockSize ? bytes : _blockSize;
+			Block block = { std::unique_ptr<unsigned char[]>(new unsigned char[size]), size };
+			_blocks.insert(_blocks.begin() + _current, std::move(block));
+		}
+		_used = 0;
+		start = 0;
+	}
+	_used = start + bytes;
+	_allocatedThisFrame += bytes;
+	return _blocks[_current].memory.get() + start;
+}
+
+void VyFrameArena::Reset() {
+	for (int i = (int)_destructors.size() - 1; i >= 0; --i) {
+		_destructors[i].destroy(_destructors[i].object);
+	}
+	_destructors.clear();
+	if (_allocatedThisFrame > _peak) {
+		_peak = _allocatedThisFrame;
+	}
+	_allocatedThisFrame = 0;
+	_current = -1;
+	_used = 0;
+}
+
+size_t VyFrameArena::GetCapacity() const {
+	size_t capacity = 0;
+	for (int i = 0; i < _blocks.size(); ++i) {
+		capacity += _blocks[i].size;
+	}
+	return capacity;
+}
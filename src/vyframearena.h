@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <utility>
+
+/// <summary>
+/// bump allocation for things that only live until the end of the frame: allocating is a pointer increment, and Reset frees everything at once.
+/// blocks are kept between frames, so after the first few frames a frame allocates nothing from the global allocator.
+/// the engine's arena is reset at the start of <see cref="VyEngine::ProcessInput"/>
+/// </summary>
+class VyFrameArena {
+private:
+	struct Block {
+		std::unique_ptr<unsigned char[]> memory;
+		size_t size;
+	};
+	struct Destructor {
+		void(*destroy)(void*);
+		void* object;
+	};
+	std::vector<Block> _blocks;
+	/// <summary>block being bumped, and how much of it is used</summary>
+	int _current;
+	size_t _used;
+	size_t _blockSize;
+	/// <summary>for objects from New that aren't trivially destructible, run in reverse by Reset</summary>
+	std::vector<Destructor> _destructors;
+	size_t _allocatedThisFrame;
+	size_t _peak;
+public:
+	VyFrameArena(size_t blockSize = 64 * 1024);
+	~VyFrameArena();
+	/// <summary>
+	/// valid until the next Reset. never NULL
+	/// </summary>
+	/// <param name="align">a power of two, at most alignof(std::max_align_t)</param>
+	void* Allocate(size_t bytes, size_t align = alignof(std::max_align_t));
+	/// <summary>
+	/// constructs a T in the arena. its destructor, if it has one that does anything, runs on Reset
+	/// </summary>
+	template<typename T, typename... Args>
+	T* New(Args&&... args) {
+		T* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		if (!std::is_trivially_destructible<T>::value) {
+			_destructors.push_back({ [](void* o) { ((T*)o)->~T(); }, object });
+		}
+		return object;
+	}
+	/// <summary>
+	/// destroys everything from New, and makes all the arena's memory available again
+	/// </summary>
+	void Reset();
+	/// <summary>bytes handed out since the last Reset</summary>
+	size_t GetAllocated() const { return _allocatedThisFrame; }
+	/// <summary>most bytes handed out in one frame</summary>
+	size_t GetPeak() const { return _peak; }
+	size_t GetCapacity() const;
+};
+
+/// <summary>
+/// standard allocator over a <see cref="VyFrameArena"/>, for scratch containers that are thrown away within the frame.
+/// deallocate does nothing: memory comes back on Reset
+/// </summary>
+template<typename T>
+class VyArenaAllocator {
+public:
+	typedef T value_type;
+	VyFrameArena* arena;
+	VyArenaAllocator(VyFrameArena* arena) : arena(arena) {}
+	template<typename U>
+	VyArenaAllocator(const VyArenaAllocator<U>& other) : arena(other.arena) {}
+	T* allocate(size_t count) { return (T*)arena->Allocate(sizeof(T) * count, alignof(T)); }
+	void deallocate(T* block, size_t count) {}
+	template<typename U>
+	bool operator==(const VyArenaAllocator<U>& other) const { return arena == other.arena; }
+	template<typename U>
+	bool operator!=(const VyArenaAllocator<U>& other) const { return arena != other.arena; }
+};
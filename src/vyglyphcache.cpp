@@ -0,0 +1,104 @@
+#include "vyglyphcache.h"
+#include "vyspritebatch.h"
+#include "vyrenderqueue.h"
+#include "vyprofiler.h"
+
+VyGlyphCache::VyGlyphCache(TTF_Font* font, VyTextureAtlas* atlas) : _font(font), _atlas(atlas), _height(TTF_FontHeight(font)), _glyphs() {}
+
+Uint32 VyGlyphCache::NextCodepoint(const std::string& text, size_t& index) {
+	Uint8 c = (Uint8)text[index++];
+	if (c < 0x80) { return c; }
+	int extra = (c & 0xE0) == 0xC0 ? 1 : (c & 0xF0) == 0xE0 ? 2 : (c & 0xF8) == 0xF0 ? 3 : -1;
+	if (extra < 0 || index + extra > text.size()) { return '?'; }
+	Uint32 codepoint = c & (0x3F >> extra);
+	for (int i = 0; i < extra; ++i) {
+		Uint8 next = (Uint8)text[index];
+		if ((next & 0xC0) != 0x80) { return '?'; }
+		codepoint = (codepoint << 6) | (next & 0x3F);
+		++index;
+	}
+	return codepoint;
+}
+
+VyEngine::ErrorCode VyGlyphCache::Load(Uint32 codepoint, Glyph& glyph) {
+	int minX, maxX, minY, maxY;
+	if (TTF_GlyphMetrics32(_font, codepoint, &minX, &maxX, &minY, &maxY, &glyph.advance) != 0) {
+		// missing from the font: draws as nothing
+		glyph.advance = 0;
+		glyph.loaded = true;
+		return VyEngine::ErrorCode::Success;
+	}
+	const SDL_Color white = { 0xFF, 0xFF, 0xFF, 0xFF };
+	SDL_Surface* surface = TTF_RenderGlyph32_Blended(_font, codepoint, white);
+	if (surface == NULL) {
+		VyEngine::GetInstance()->ErrorMessage = string_format("Failed to render glyph %u! SDL Error: %s\n", codepoint, TTF_GetError());
+		return VyEngine::ErrorCode::Failure;
+	}
+	VyEngine::ErrorCode err = _atlas->Add(surface, glyph.sprite);
+	SDL_FreeSurface(surface);
+	// a failed render or a full atlas is tried again on the next lookup
+	glyph.loaded = err == VyEngine::ErrorCode::Success;
+	return err;
+}
+
+const VyGlyphCache::Glyph* VyGlyphCache::GetGlyph(Uint32 codepoint) {
+	Glyph& glyph = codepoint < 128 ? _ascii[codepoint] : _glyphs[codepoint];
+	if (!glyph.loaded && Load(codepoint, glyph) != VyEngine::ErrorCode::Success) {
+		return NULL;
+	}
+	return &glyph;
+}
+
+VyEngine::ErrorCode VyGlyphCache::Prepare(const std::string& text) {
+	for (size_t i = 0; i < text.size();) {
+		if (GetGlyph(NextCodepoint(text, i)) == NULL) { return VyEngine::ErrorCode::Failure; }
+	}
+	return VyEngine::ErrorCode::Success;
+}
+
+template<typename Place>
+VyEngine::ErrorCode VyGlyphCache::Layout(const std::string& text, Coord position, Place place) {
+	int penX = position.x;
+	Uint32 previous = 0;
+	for (size_t i = 0; i < text.size();) {
+		Uint32 codepoint = NextCodepoint(text, i);
+		const Glyph* glyph = GetGlyph(codepoint);
+		if (glyph == NULL) { return VyEngine::ErrorCode::Failure; }
+		if (previous != 0) {
+			penX += TTF_GetFontKerningSizeGlyphs32(_font, previous, codepoint);
+		}
+		if (glyph->sprite.IsValid()) {
+			// each glyph surface is a full line tall with the baseline in place, so its top sits on the line's top
+			place(glyph->sprite, Rect(penX, position.y, glyph->sprite.source.w, glyph->sprite.source.h));
+		}
+		penX += glyph->advance;
+		previous = codepoint;
+	}
+	return VyEngine::ErrorCode::Success;
+}
+
+VyEngine::ErrorCode VyGlyphCache::Draw(VySpriteBatch& batch, const std::string& text, Coord position, SDL_Color color) {
+	VY_PROFILE_ZONE("VyGlyphCache::Draw");
+	return Layout(text, position, [&](const VyAtlasSprite& sprite, const Rect& dest) { batch.Draw(sprite, dest, color); });
+}
+
+VyEngine::ErrorCode VyGlyphCache::Record(VyRenderQueue& queue, const std::string& text, Coord position, SDL_Color color, int layer) {
+	VY_PROFILE_ZONE("VyGlyphCache::Record");
+	return Layout(text, position, [&](const VyAtlasSprite& sprite, const Rect& dest) { queue.Sprite(sprite, dest, color, layer); });
+}
+
+Coord VyGlyphCache::Measure(const std::string& text) {
+	int width = 0;
+	Uint32 previous = 0;
+	for (size_t i = 0; i < text.size();) {
+		Uint32 codepoint = NextCodepoint(text, i);
+		const Glyph* glyph = GetGlyph(codepoint);
+		if (glyph == NULL) { break; }
+		if (previous != 0) {
+			width += TTF_GetFontKerningSizeGlyphs32(_font, previous, codepoint);
+		}
+		width += glyph->advance;
+		previous = codepoint;
+	}
+	return Coord(width, _height);
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <unordered_map>
+#include "vyatlas.h"
+
+class VySpriteBatch;
+class VyRenderQueue;
+
+/// <summary>
+/// rasterizes each glyph of one font (one name and size) once, white, into a <see cref="VyTextureAtlas"/>.
+/// text is then drawn as tinted quads through a <see cref="VySpriteBatch"/>, so changing a string never touches a texture
+/// </summary>
+class VyGlyphCache {
+private:
+	struct Glyph {
+		VyAtlasSprite sprite;
+		int advance;
+		bool loaded;
+		Glyph() : sprite(), advance(0), loaded(false) {}
+	};
+	TTF_Font* _font;
+	VyTextureAtlas* _atlas;
+	int _height;
+	/// <summary>ASCII, looked up without hashing</summary>
+	Glyph _ascii[128];
+	std::unordered_map<Uint32, Glyph> _glyphs;
+public:
+	VyGlyphCache(TTF_Font* font, VyTextureAtlas* atlas);
+	/// <summary>
+	/// rasterizes every glyph in text now, instead of on first draw
+	/// </summary>
+	VyEngine::ErrorCode Prepare(const std::string& text);
+	/// <param name="text">UTF-8</param>
+	/// <param name="position">top left of the line, like the dest rect of TTF_RenderText</param>
+	VyEngine::ErrorCode Draw(VySpriteBatch& batch, const std::string& text, Coord position, SDL_Color color);
+	/// <summary>
+	/// like <see cref="VyGlyphCache::Draw"/>, as commands in a <see cref="VyRenderQueue"/>
+	/// </summary>
+	VyEngine::ErrorCode Record(VyRenderQueue& queue, const std::string& text, Coord position, SDL_Color color, int layer = 0);
+	/// <returns>width and line height of text, as drawn by <see cref="VyGlyphCache::Draw"/></returns>
+	Coord Measure(const std::string& text);
+	TTF_Font* GetFont() const { return _font; }
+	int GetHeight() const { return _height; }
+private:
+	/// <summary>
+	/// decodes one UTF-8 code point at index and advances index. invalid bytes decode as '?'
+	/// </summary>
+	static Uint32 NextCodepoint(const std::string& text, size_t& index);
+	const Glyph* GetGlyph(Uint32 codepoint);
+	/// <summary>
+	/// calls place(sprite, dest) for each visible glyph of text, kerned
+	/// </summary>
+	template<typename Place>
+	VyEngine::ErrorCode Layout(const std::string& text, Coord position, Place place);
+	VyEngine::ErrorCode Load(Uint32 codepoint, Glyph& glyph);
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include "coord.h"
+#include "rect.h"
 #include "vyobjectcommonbase.h"
 #include "componentcontainer.h"
 
@@ -11,13 +13,47 @@ public:
 	virtual void SetParent(std::shared_ptr<VyHierarchedInterface> parent) = 0;
 };
 
-class VyHierarched : public VyObjectCommonBase, public VyComponentContainer {
+/// <summary>
+/// a scene graph node. its position is relative to its parent, and components with a rect (<see cref="HasRect"/>) keep their offset from it,
+/// so moving a node is one dirty mark that carries everything below it along.
+/// the root keeps its tree flattened depth-first, rebuilt only when nodes are added or removed, and resolves world positions over that array:
+/// a parent always comes before its children, so one linear pass updates every moved subtree.
+/// Update, Draw and HandleEvent on the root are linear scans of the same array. on a child they only reach its own components, the root reaches the rest
+/// </summary>
+class VyHierarched : public VyObjectCommonBase, public VyComponentContainer, public VyHierarchedInterface {
 public:
 private:
+	struct AttachedRect {
+		HasRect* rect;
+		/// <summary>from the node's world position</summary>
+		Coord offset;
+	};
+	struct FlatNode {
+		VyHierarched* node;
+		/// <summary>index of the parent in the flattened array, -1 for the root</summary>
+		int parent;
+	};
 	std::vector<std::shared_ptr<VyHierarchedInterface>> _children;
 	std::shared_ptr<VyHierarchedInterface> _parent;
+	/// <summary>the node of each of _children, which owns it: the child itself, or the hierarchy member of a game object</summary>
+	std::vector<VyHierarched*> _childNodes;
+	/// <summary>not owned, the parent owns this node through its _children</summary>
+	VyHierarched* _parentNode;
+	std::vector<AttachedRect> _rects;
+	Coord _localPosition;
+	Coord _worldPosition;
+	/// <summary>the local position changed since world positions were last resolved</summary>
+	bool _transformDirty;
+	/// <summary>on a root: nodes were added or removed below it since _flattened was built</summary>
+	bool _hierarchyDirty;
+	/// <summary>on a root: some node below it has _transformDirty, so UpdateTransforms can skip the scan when nothing moved</summary>
+	bool _anyTransformDirty;
+	std::vector<FlatNode> _flattened;
+	/// <summary>per flattened node, whether its world position changed in the current UpdateTransforms pass</summary>
+	std::vector<char> _moved;
 public:
-	VyHierarched(std::string name) : VyObjectCommonBase(name), _children() {}
+	VyHierarched(std::string name) : VyObjectCommonBase(name), _children(), _parentNode(NULL), _localPosition(), _worldPosition(),
+		_transformDirty(false), _hierarchyDirty(true), _anyTransformDirty(false) {}
 	virtual int GetChildCount() const { return (int)_children.size(); }
 	virtual std::shared_ptr <VyHierarchedInterface> GetChild(int index) { return _children[index]; }
 	virtual std::shared_ptr<VyHierarchedInterface> GetParent() const { return _parent; }
@@ -25,4 +61,183 @@ public:
 	virtual VyEventProcessor* AsEventProcessor() { return this; }
 	virtual VyDrawable* AsDrawable() { return this; }
 	virtual VyUpdatable* AsUpdatable() { return this; }
+
+	/// <summary>
+	/// adds child below this node. node is the child's hierarchy node, kept alive by child.
+	/// SetParent is left to whoever holds this node's shared_ptr, the node link is enough for transforms and traversal.
+	/// not from inside the tree's Update, Draw or HandleEvent: queue it with <see cref="VyEngine::Queue"/>
+	/// </summary>
+	void AddChild(std::shared_ptr<VyHierarchedInterface> child, VyHierarched* node) {
+		_children.push_back(child);
+		_childNodes.push_back(node);
+		node->_parentNode = this;
+		node->_transformDirty = true;
+		node->_flattened.clear();
+		node->_moved.clear();
+		MarkHierarchyDirty();
+	}
+	void AddChild(std::shared_ptr<VyHierarched> child) { AddChild(child, child.get()); }
+	void RemoveChild(int index) {
+		VyHierarched* node = _childNodes[index];
+		node->_parentNode = NULL;
+		node->_transformDirty = true;
+		node->_hierarchyDirty = true;
+		node->_anyTransformDirty = true;
+		MarkHierarchyDirty();
+		_childNodes.erase(_childNodes.begin() + index);
+		_children.erase(_children.begin() + index);
+	}
+	VyHierarched* GetParentNode() const { return _parentNode; }
+	VyHierarched* GetRoot() {
+		VyHierarched* root = this;
+		while (root->_parentNode != NULL) {
+			root = root->_parentNode;
+		}
+		return root;
+	}
+
+	const Coord& GetLocalPosition() const { return _localPosition; }
+	/// <summary>
+	/// one dirty mark however big the subtree is: children follow when the root next resolves world positions
+	/// </summary>
+	void SetLocalPosition(const Coord& position) {
+		if (position == _localPosition) { return; }
+		_localPosition = position;
+		_transformDirty = true;
+		GetRoot()->_anyTransformDirty = true;
+	}
+	/// <summary>
+	/// cached, as of the root's last <see cref="VyHierarched::UpdateTransforms"/>
+	/// </summary>
+	const Coord& GetWorldPosition() const { return _worldPosition; }
+	/// <summary>
+	/// up through every ancestor, uncached. for when the cache may be stale, like before the first traversal
+	/// </summary>
+	Coord ComputeWorldPosition() const {
+		return _parentNode != NULL ? _parentNode->ComputeWorldPosition() + _localPosition : _localPosition;
+	}
+
+	using VyComponentContainer::AddComponent;
+	/// <summary>
+	/// a component with a rect keeps its current position as an offset from this node, and is placed in the world right away
+	/// </summary>
+	virtual void AddComponent(std::shared_ptr<VyInterface> ptr) {
+		VyComponentContainer::AddComponent(ptr);
+		HasRect* rect = ptr->AsRect();
+		if (rect != NULL) {
+			AttachedRect attached = { rect, rect->GetRect()->GetPosition() };
+			_rects.push_back(attached);
+			rect->MoveRectTo(ComputeWorldPosition() + attached.offset);
+		}
+	}
+
+	/// <summary>
+	/// rebuilds the flattened tree if nodes were added or removed, then resolves the world position of every node that moved or is below one
+	/// that did, and places their rect components. nothing to do when nothing moved. called on a child, resolves its root
+	/// </summary>
+	void UpdateTransforms() {
+		if (_parentNode != NULL) {
+			GetRoot()->UpdateTransforms();
+			return;
+		}
+		Flatten();
+		if (!_anyTransformDirty) { return; }
+		_anyTransformDirty = false;
+		for (size_t i = 0; i < _flattened.size(); ++i) {
+			const FlatNode& flat = _flattened[i];
+			VyHierarched* node = flat.node;
+			bool moved = node->_transformDirty || (flat.parent >= 0 && _moved[flat.parent]);
+			_moved[i] = moved;
+			if (!moved) { continue; }
+			node->_worldPosition = flat.parent >= 0
+				? _flattened[flat.parent].node->_worldPosition + node->_localPosition
+				: node->_localPosition;
+			node->_transformDirty = false;
+			node->PlaceRects();
+		}
+	}
+
+	virtual void Update() {
+		if (_parentNode != NULL) {
+			VyComponentContainer::Update();
+			return;
+		}
+		UpdateTransforms();
+		for (const FlatNode& flat : _flattened) {
+			flat.node->VyComponentContainer::Update();
+		}
+	}
+	virtual void Draw(SDL_Renderer* g, const Coord& offset) {
+		if (_parentNode != NULL) {
+			VyComponentContainer::Draw(g, offset);
+			return;
+		}
+		// again, for whatever moved during Update
+		UpdateTransforms();
+		for (const FlatNode& flat : _flattened) {
+			flat.node->VyComponentContainer::Draw(g, offset);
+		}
+	}
+	virtual void HandleEvent(const SDL_Event& e) {
+		if (_parentNode != NULL) {
+			VyComponentContainer::HandleEvent(e);
+			return;
+		}
+		Flatten();
+		for (const FlatNode& flat : _flattened) {
+			flat.node->VyComponentContainer::HandleEvent(e);
+		}
+	}
+	/// <summary>
+	/// what any component in the subtree subscribes to
+	/// </summary>
+	virtual Uint32 GetEventMask() const {
+		Uint32 mask = VyComponentContainer::GetEventMask();
+		for (const VyHierarched* child : _childNodes) {
+			mask |= child->GetEventMask();
+		}
+		return mask;
+	}
+	/// <summary>
+	/// when every component in the subtree is
+	/// </summary>
+	virtual bool IsParallelSafe() const {
+		if (!VyComponentContainer::IsParallelSafe()) { return false; }
+		for (const VyHierarched* child : _childNodes) {
+			if (!child->IsParallelSafe()) { return false; }
+		}
+		return true;
+	}
+	/// <summary>
+	/// nodes in the flattened tree, counting the root. only meaningful on a root
+	/// </summary>
+	int GetFlattenedCount() {
+		Flatten();
+		return (int)_flattened.size();
+	}
+private:
+	void MarkHierarchyDirty() {
+		GetRoot()->_hierarchyDirty = true;
+	}
+	void Flatten() {
+		if (!_hierarchyDirty) { return; }
+		_flattened.clear();
+		AppendFlattened(this, -1);
+		_moved.assign(_flattened.size(), 0);
+		_hierarchyDirty = false;
+		// added nodes are marked dirty, and need placing under their new parents
+		_anyTransformDirty = true;
+	}
+	void AppendFlattened(VyHierarched* node, int parent) {
+		int index = (int)_flattened.size();
+		_flattened.push_back({ node, parent });
+		for (VyHierarched* child : node->_childNodes) {
+			AppendFlattened(child, index);
+		}
+	}
+	void PlaceRects() {
+		for (const AttachedRect& attached : _rects) {
+			attached.rect->MoveRectTo(_worldPosition + attached.offset);
+		}
+	}
 };
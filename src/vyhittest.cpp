@@ -0,0 +1,108 @@
+#include "vyhittest.h"
+#include <algorithm>
+
+VyHitTestGrid::VyHitTestGrid(int cellSize) : _cellSize(cellSize), _nextOrder(0), _version(0) {}
+
+Uint64 VyHitTestGrid::CellKey(int cellX, int cellY) {
+	return ((Uint64)(Uint32)cellX << 32) | (Uint32)cellY;
+}
+
+int VyHitTestGrid::CellOf(int value) const {
+	// floor division, so negative coordinates land in their own cells
+	return value >= 0 ? value / _cellSize : -((-value + _cellSize - 1) / _cellSize);
+}
+
+void VyHitTestGrid::Insert(int id) {
+	const Rect& r = _entries[id].rect;
+	if (r.w <= 0 || r.h <= 0) { return; }
+	int minX = CellOf(r.x), minY = CellOf(r.y), maxX = CellOf(r.x + r.w - 1), maxY = CellOf(r.y + r.h - 1);
+	for (int cy = minY; cy <= maxY; ++cy) {
+		for (int cx = minX; cx <= maxX; ++cx) {
+			_cells[CellKey(cx, cy)].push_back(id);
+		}
+	}
+}
+
+void VyHitTestGrid::Erase(int id) {
+	const Rect& r = _entries[id].rect;
+	if (r.w <= 0 || r.h <= 0) { return; }
+	int minX = CellOf(r.x), minY = CellOf(r.y), maxX = CellOf(r.x + r.w - 1), maxY = CellOf(r.y + r.h - 1);
+	for (int cy = minY; cy <= maxY; ++cy) {
+		for (int cx = minX; cx <= maxX; ++cx) {
+			auto found = _cells.find(CellKey(cx, cy));
+			if (found == _cells.end()) { continue; }
+			std::vector<int>& cell = found->second;
+			auto it = std::find(cell.begin(), cell.end(), id);
+			if (it != cell.end()) {
+				*it = cell.back();
+				cell.pop_back();
+			}
+			if (cell.empty()) {
+				_cells.erase(found);
+			}
+		}
+	}
+}
+
+void VyHitTestGrid::Add(VyPointerTarget* target, const Rect& rect) {
+	if (_ids.find(target) != _ids.end()) {
+		Move(target, rect);
+		return;
+	}
+	int id;
+	if (!_freeEntries.empty()) {
+		id = _freeEntries.back();
+		_freeEntries.pop_back();
+	} else {
+		id = (int)_entries.size();
+		_entries.emplace_back();
+	}
+	_entries[id] = { rect, target, _nextOrder++, true };
+	_ids[target] = id;
+	Insert(id);
+	++_version;
+}
+
+void VyHitTestGrid::Move(VyPointerTarget* target, const Rect& rect) {
+	auto found = _ids.find(target);
+	if (found == _ids.end()) { return; }
+	Entry& entry = _entries[found->second];
+	if (entry.rect.x == rect.x && entry.rect.y == rect.y && entry.rect.w == rect.w && entry.rect.h == rect.h) { return; }
+	Erase(found->second);
+	entry.rect = rect;
+	Insert(found->second);
+	++_version;
+}
+
+void VyHitTestGrid::SetActive(VyPointerTarget* target, bool active) {
+	auto found = _ids.find(target);
+	if (found == _ids.end() || _entries[found->second].active == active) { return; }
+	_entries[found->second].active = active;
+	++_version;
+}
+
+void VyHitTestGrid::Remove(VyPointerTarget* target) {
+	auto found = _ids.find(target);
+	if (found == _ids.end()) { return; }
+	int id = found->second;
+	Erase(id);
+	_entries[id].target = NULL;
+	_freeEntries.push_back(id);
+	_ids.erase(found);
+	++_version;
+}
+
+VyPointerTarget* VyHitTestGrid::Pick(const Coord& point) const {
+	auto found = _cells.find(CellKey(CellOf(point.x), CellOf(point.y)));
+	if (found == _cells.end()) { return NULL; }
+	const Entry* best = NULL;
+	for (int id : found->second) {
+		const Entry& entry = _entries[id];
+		if (!entry.active || (best != NULL && entry.order < best->order)) { continue; }
+		const Rect& r = entry.rect;
+		if (point.x >= r.x && point.y >= r.y && point.x < r.x + r.w && point.y < r.y + r.h) {
+			best = &entry;
+		}
+	}
+	return best != NULL ? best->target : NULL;
+}
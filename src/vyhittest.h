@@ -0,0 +1,65 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <unordered_map>
+#include "rect.h"
+
+/// <summary>
+/// something that receives mouse button events routed by <see cref="VyEngine"/> through a <see cref="VyHitTestGrid"/>
+/// </summary>
+class VyPointerTarget {
+public:
+	/// <summary>
+	/// mouse button down/up. down goes to the topmost target under the mouse, up goes to the target that got the down.
+	/// each is then repeated for every <see cref="VyPointerTarget::GetPointerParent"/>
+	/// </summary>
+	virtual void HandlePointerEvent(const SDL_Event& e) = 0;
+	/// <summary>
+	/// called when the mouse enters or leaves the topmost position over this target
+	/// </summary>
+	virtual void SetHovered(bool hovered) {}
+	/// <summary>
+	/// called when a mouse down lands on this target (true), or lands anywhere else after it did (false)
+	/// </summary>
+	virtual void SetPointerFocused(bool focused) {}
+	virtual VyPointerTarget* GetPointerParent() { return nullptr; }
+};
+
+/// <summary>
+/// uniform grid over target rects, so picking the topmost target at a point only looks at one cell.
+/// targets added later are on top, matching draw order
+/// </summary>
+class VyHitTestGrid {
+private:
+	struct Entry {
+		Rect rect;
+		VyPointerTarget* target;
+		Uint32 order;
+		bool active;
+	};
+	int _cellSize;
+	std::vector<Entry> _entries;
+	std::vector<int> _freeEntries;
+	std::unordered_map<VyPointerTarget*, int> _ids;
+	std::unordered_map<Uint64, std::vector<int>> _cells;
+	Uint32 _nextOrder;
+	Uint32 _version;
+public:
+	VyHitTestGrid(int cellSize = 64);
+	void Add(VyPointerTarget* target, const Rect& rect);
+	void Move(VyPointerTarget* target, const Rect& rect);
+	void SetActive(VyPointerTarget* target, bool active);
+	void Remove(VyPointerTarget* target);
+	/// <returns>the topmost active target containing point, or NULL</returns>
+	VyPointerTarget* Pick(const Coord& point) const;
+	int GetCount() const { return (int)_ids.size(); }
+	/// <summary>
+	/// changes whenever a target is added, moved, removed or (de)activated
+	/// </summary>
+	Uint32 GetVersion() const { return _version; }
+private:
+	static Uint64 CellKey(int cellX, int cellY);
+	int CellOf(int value) const;
+	void Insert(int id);
+	void Erase(int id);
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, size_t Capacity = 32>
+class VyInlineFunction;
+
+/// <summary>
+/// a copyable callable, like std::function, that stores callables up to Capacity bytes inside itself instead of on the heap.
+/// lambdas capturing a few pointers (the common delegate) never allocate. larger callables fall back to the heap.
+/// </summary>
+template<typename R, typename... Args, size_t Capacity>
+class VyInlineFunction<R(Args...), Capacity> {
+private:
+	struct Operations {
+		R(*invoke)(void* storage, Args... args);
+		void(*copy)(void* destination, const void* source);
+		void(*move)(void* destination, void* source);
+		void(*destroy)(void* storage);
+		bool isInline;
+	};
+
+	template<typename F>
+	struct InlineOperations {
+		static R Invoke(void* storage, Args... args) { return (*(F*)storage)(std::forward<Args>(args)...); }
+		static void Copy(void* destination, const void* source) { new (destination) F(*(const F*)source); }
+		static void Move(void* destination, void* source) { new (destination) F(std::move(*(F*)source)); ((F*)source)->~F(); }
+		static void Destroy(void* storage) { ((F*)storage)->~F(); }
+		static const Operations Table;
+	};
+
+	template<typename F>
+	struct HeapOperations {
+		static F*& Pointer(void* storage) { return *(F**)storage; }
+		static R Invoke(void* storage, Args... args) { return (*Pointer(storage))(std::forward<Args>(args)...); }
+		static void Copy(void* destination, const void* source) { *(F**)destination = new F(**(F* const*)source); }
+		static void Move(void* destination, void* source) { *(F**)destination = Pointer(source); Pointer(source) = nullptr; }
+		static void Destroy(void* storage) { delete Pointer(storage); }
+		static const Operations Table;
+	};
+
+	template<typename F>
+	static constexpr bool FitsInline() {
+		return sizeof(F) <= Capacity && alignof(std::max_align_t) % alignof(F) == 0
+			&& std::is_nothrow_move_constructible<F>::value;
+	}
+
+	alignas(std::max_align_t) unsigned char _storage[Capacity];
+	const Operations* _operations;
+
+	template<typename Callable, typename F>
+	void Construct(F&& callable, std::true_type /*fitsInline*/) {
+		new (_storage) Callable(std::forward<F>(callable));
+		_operations = &InlineOperations<Callable>::Table;
+	}
+
+	template<typename Callable, typename F>
+	void Construct(F&& callable, std::false_type /*fitsInline*/) {
+		*(Callable**)_storage = new Callable(std::forward<F>(callable));
+		_operations = &HeapOperations<Callable>::Table;
+	}
+public:
+	VyInlineFunction() : _operations(nullptr) {}
+	VyInlineFunction(std::nullptr_t) : _operations(nullptr) {}
+
+	template<typename F, typename = typename std::enable_if<
+		!std::is_same<typename std::decay<F>::type, VyInlineFunction>::value>::type>
+	VyInlineFunction(F&& callable) : _operations(nullptr) {
+		typedef typename std::decay<F>::type Callable;
+		Construct<Callable>(std::forward<F>(callable), std::integral_constant<bool, FitsInline<Callable>()>());
+	}
+
+	VyInlineFunction(const VyInlineFunction& other) : _operations(other._operations) {
+		if (_operations) { _operations->copy(_storage, other._storage); }
+	}
+
+	VyInlineFunction(VyInlineFunction&& other) noexcept : _operations(other._operations) {
+		if (_operations) {
+			_operations->move(_storage, other._storage);
+			other._operations = nullptr;
+		}
+	}
+
+	~VyInlineFunction() { Reset(); }
+
+	VyInlineFunction& operator=(const VyInlineFunction& other) {
+		if (this != &other) {
+			Reset();
+			_operations = other._operations;
+			if (_operations) { _operations->copy(_storage, other._storage); }
+		}
+		return *this;
+	}
+
+	VyInlineFunction& operator=(VyInlineFunction&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			_operations = other._operations;
+			if (_operations) {
+				_operations->move(_storage, other._storage);
+				other._operations = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	void Reset() {
+		if (_operations) {
+			_operations->destroy(_storage);
+			_operations = nullptr;
+		}
+	}
+
+	explicit operator bool() const { return _operations != nullptr; }
+
+	/// <returns>true if the callable is stored without a heap allocation</returns>
+	bool IsInline() const { return _operations == nullptr || _operations->isInline; }
+
+	/// <summary>
+	/// must not be empty
+	/// </summary>
+	R operator()(Args... args) const {
+		return _operations->invoke((void*)_storage, std::forward<Args>(args)...);
+	}
+};
+
+template<typename R, typename... Args, size_t Capacity>
+template<typename F>
+const typename VyInlineFunction<R(Args...), Capacity>::Operations VyInlineFunction<R(Args...), Capacity>::InlineOperations<F>::Table = {
+	&InlineOperations<F>::Invoke, &InlineOperations<F>::Copy, &InlineOperations<F>::Move, &InlineOperations<F>::Destroy, true
+};
+
+template<typename R, typename... Args, size_t Capacity>
+template<typename F>
+const typename VyInlineFunction<R(Args...), Capacity>::Operations VyInlineFunction<R(Args...), Capacity>::HeapOperations<F>::Table = {
+	&HeapOperations<F>::Invoke, &HeapOperations<F>::Copy, &HeapOperations<F>::Move, &HeapOperations<F>::Destroy, false
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <SDL.h>
+#include <string.h>
+#include "coord.h"
+
+/// <summary>
+/// keyboard and mouse state for one frame, built once by <see cref="VyEngine::ProcessInput"/>.
+/// reads are single bit tests with no bounds checks: scancodes must be below SDL_NUM_SCANCODES, mouse buttons below 32.
+/// "pressed"/"released" are edges that happened this frame, so a tap inside one frame is both pressed and released while never held.
+/// </summary>
+class VyInputSnapshot {
+public:
+	static const int KeyWords = (SDL_NUM_SCANCODES + 63) / 64;
+	Uint64 keyHeld[KeyWords];
+	Uint64 keyPressed[KeyWords];
+	Uint64 keyReleased[KeyWords];
+	Uint32 mouseHeld;
+	Uint32 mousePressed;
+	Uint32 mouseReleased;
+	Coord mousePosition;
+	/// <summary>sum of relative motion this frame</summary>
+	Coord mouseDelta;
+	/// <summary>sum of wheel movement this frame</summary>
+	Coord wheel;
+	Uint64 frame;
+
+	VyInputSnapshot() : mouseHeld(0), mousePressed(0), mouseReleased(0), mousePosition(), mouseDelta(), wheel(), frame(0) {
+		memset(keyHeld, 0, sizeof(keyHeld));
+		memset(keyPressed, 0, sizeof(keyPressed));
+		memset(keyReleased, 0, sizeof(keyReleased));
+	}
+
+	inline bool IsHeld(SDL_Scancode key) const { return Bit(keyHeld, key); }
+	inline bool IsPressed(SDL_Scancode key) const { return Bit(keyPressed, key); }
+	inline bool IsReleased(SDL_Scancode key) const { return Bit(keyReleased, key); }
+	/// <param name="button">SDL_BUTTON_LEFT, SDL_BUTTON_MIDDLE, SDL_BUTTON_RIGHT...</param>
+	inline bool IsMouseHeld(int button) const { return ((mouseHeld >> (button & 31)) & 1) != 0; }
+	inline bool IsMousePressed(int button) const { return ((mousePressed >> (button & 31)) & 1) != 0; }
+	inline bool IsMouseReleased(int button) const { return ((mouseReleased >> (button & 31)) & 1) != 0; }
+
+	/// <summary>
+	/// convenience for keycodes (SDLK_*). SDL_GetScancodeFromKey is a table lookup, so prefer caching the scancode
+	/// </summary>
+	static SDL_Scancode ToScancode(SDL_Keycode key) {
+		if ((key & SDLK_SCANCODE_MASK) != 0) {
+			return (SDL_Scancode)(key & ~SDLK_SCANCODE_MASK);
+		}
+		return SDL_GetScancodeFromKey(key);
+	}
+
+	/// <summary>
+	/// called by <see cref="VyEngine::ProcessEvent"/>. repeat is SDL_KeyboardEvent::repeat, which doesn't count as a new press
+	/// </summary>
+	void SetKey(SDL_Scancode key, bool pressed, bool repeat) {
+		if (key < 0 || key >= SDL_NUM_SCANCODES) { return; }
+		Uint64 bit = (Uint64)1 << (key & 63);
+		int word = key >> 6;
+		if (pressed) {
+			keyHeld[word] |= bit;
+			if (!repeat) { keyPressed[word] |= bit; }
+		} else {
+			keyHeld[word] &= ~bit;
+			keyReleased[word] |= bit;
+		}
+	}
+
+	void SetMouseButton(int button, bool pressed) {
+		Uint32 bit = (Uint32)1 << (button & 31);
+		if (pressed) {
+			mouseHeld |= bit;
+			mousePressed |= bit;
+		} else {
+			mouseHeld &= ~bit;
+			mouseReleased |= bit;
+		}
+	}
+
+	/// <summary>
+	/// clears edges and per-frame sums, keeping what is held, ready to collect the next frame
+	/// </summary>
+	void BeginFrame() {
+		memset(keyPressed, 0, sizeof(keyPressed));
+		memset(keyReleased, 0, sizeof(keyReleased));
+		mousePressed = 0;
+		mouseReleased = 0;
+		mouseDelta = Coord::Zero;
+		wheel = Coord::Zero;
+		++frame;
+	}
+private:
+	static inline bool Bit(const Uint64* bits, SDL_Scancode key) {
+		return ((bits[key >> 6] >> (key & 63)) & 1) != 0;
+	}
+};
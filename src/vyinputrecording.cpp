@@ -0,0 +1,309 @@
+#include "vyinputrecording.h"
+#include <string.h>
+#include "stringstuff.h"
+
+static const char Magic[4] = { 'V', 'Y', 'I', 'N' };
+static const Uint8 Version = 1;
+/// <summary>past this many encoded bytes, the recorder writes them out</summary>
+static const size_t FlushSize = 64 * 1024;
+
+enum class RecordKind : Uint8 {
+	End, Steps, KeyDown, KeyUp, TextInput, MouseMotion, MouseButtonDown, MouseButtonUp, MouseWheel, Window, Quit, Count
+};
+
+static void WriteVarint(std::vector<Uint8>& out, Uint32 value) {
+	while (value >= 0x80) {
+		out.push_back((Uint8)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((Uint8)value);
+}
+
+/// <summary>
+/// zigzag, so small negative numbers (relative mouse motion) stay small
+/// </summary>
+static void WriteSigned(std::vector<Uint8>& out, Sint32 value) {
+	WriteVarint(out, ((Uint32)value << 1) ^ (Uint32)(value >> 31));
+}
+
+/// <summary>
+/// reads what WriteVarint and WriteSigned wrote. reading past the end gives zeros and sets failed
+/// </summary>
+class RecordReader {
+private:
+	const Uint8* _read;
+	const Uint8* _end;
+public:
+	bool failed;
+	RecordReader(const Uint8* data, size_t size) : _read(data), _end(data + size), failed(false) {}
+	bool IsAtEnd() const { return _read >= _end; }
+	Uint8 Byte() {
+		if (_read >= _end) {
+			failed = true;
+			return 0;
+		}
+		return *_read++;
+	}
+	Uint32 Varint() {
+		Uint32 value = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			Uint8 b = Byte();
+			value |= (Uint32)(b & 0x7f) << shift;
+			if ((b & 0x80) == 0) { return value; }
+		}
+		failed = true;
+		return 0;
+	}
+	Sint32 Signed() {
+		Uint32 value = Varint();
+		return (Sint32)(value >> 1) ^ -(Sint32)(value & 1);
+	}
+};
+
+VyInputRecorder::VyInputRecorder() : _file(NULL), _buffer(), _frame(-1), _recordedFrame(0), _lastTimestamp(0), _steps(1), _events(0), _skipped(0), _error() {}
+
+VyInputRecorder::~VyInputRecorder() {
+	std::string ignored;
+	Stop(ignored);
+}
+
+bool VyInputRecorder::Start(const std::string& path, std::string& out_error) {
+	Stop(out_error);
+	_file = SDL_RWFromFile(path.c_str(), "wb");
+	if (_file == NULL) {
+		out_error = string_format("could not create %s! SDL Error: %s", path.c_str(), SDL_GetError());
+		return false;
+	}
+	_buffer.clear();
+	_buffer.insert(_buffer.end(), Magic, Magic + sizeof(Magic));
+	_buffer.push_back(Version);
+	_frame = -1;
+	_recordedFrame = 0;
+	_lastTimestamp = 0;
+	_steps = 1;
+	_events = 0;
+	_skipped = 0;
+	_error = "";
+	return true;
+}
+
+void VyInputRecorder::BeginFrame() {
+	if (!IsRecording()) { return; }
+	EndFrame();
+	++_frame;
+	_steps = 1;
+}
+
+void VyInputRecorder::Record(const SDL_Event& e) {
+	// started in the middle of a frame: the rest of it isn't recorded
+	if (!IsRecording() || _frame < 0) { return; }
+	RecordKind kind;
+	switch (e.type) {
+	case SDL_KEYDOWN: kind = RecordKind::KeyDown; break;
+	case SDL_KEYUP: kind = RecordKind::KeyUp; break;
+	case SDL_TEXTINPUT: kind = RecordKind::TextInput; break;
+	case SDL_MOUSEMOTION: kind = RecordKind::MouseMotion; break;
+	case SDL_MOUSEBUTTONDOWN: kind = RecordKind::MouseButtonDown; break;
+	case SDL_MOUSEBUTTONUP: kind = RecordKind::MouseButtonUp; break;
+	case SDL_MOUSEWHEEL: kind = RecordKind::MouseWheel; break;
+	case SDL_WINDOWEVENT: kind = RecordKind::Window; break;
+	case SDL_QUIT: kind = RecordKind::Quit; break;
+	default:
+		++_skipped;
+		return;
+	}
+	WriteHeader(_frame, (Uint8)kind);
+	WriteSigned(_buffer, (Sint32)(e.common.timestamp - _lastTimestamp));
+	_lastTimestamp = e.common.timestamp;
+	switch (kind) {
+	case RecordKind::KeyDown:
+	case RecordKind::KeyUp:
+		WriteVarint(_buffer, (Uint32)e.key.keysym.scancode);
+		WriteSigned(_buffer, e.key.keysym.sym);
+		WriteVarint(_buffer, e.key.keysym.mod);
+		_buffer.push_back(e.key.repeat);
+		break;
+	case RecordKind::TextInput: {
+		size_t length = strnlen(e.text.text, sizeof(e.text.text) - 1);
+		_buffer.push_back((Uint8)length);
+		_buffer.insert(_buffer.end(), e.text.text, e.text.text + length);
+		break;
+	}
+	case RecordKind::MouseMotion:
+		WriteVarint(_buffer, e.motion.state);
+		WriteSigned(_buffer, e.motion.x);
+		WriteSigned(_buffer, e.motion.y);
+		WriteSigned(_buffer, e.motion.xrel);
+		WriteSigned(_buffer, e.motion.yrel);
+		break;
+	case RecordKind::MouseButtonDown:
+	case RecordKind::MouseButtonUp:
+		_buffer.push_back(e.button.button);
+		_buffer.push_back(e.button.clicks);
+		WriteSigned(_buffer, e.button.x);
+		WriteSigned(_buffer, e.button.y);
+		break;
+	case RecordKind::MouseWheel:
+		WriteSigned(_buffer, e.wheel.x);
+		WriteSigned(_buffer, e.wheel.y);
+		WriteVarint(_buffer, e.wheel.direction);
+		break;
+	case RecordKind::Window:
+		_buffer.push_back(e.window.event);
+		WriteSigned(_buffer, e.window.data1);
+		WriteSigned(_buffer, e.window.data2);
+		break;
+	default:
+		break;
+	}
+	++_events;
+	if (_buffer.size() >= FlushSize && _error == "") {
+		Flush(_error);
+	}
+}
+
+bool VyInputRecorder::Stop(std::string& out_error) {
+	if (!IsRecording()) { return true; }
+	EndFrame();
+	WriteHeader(GetFrameCount(), (Uint8)RecordKind::End);
+	bool written = _error == "" && Flush(_error);
+	if (SDL_RWclose(_file) != 0 && written) {
+		_error = string_format("could not close the recording! SDL Error: %s", SDL_GetError());
+		written = false;
+	}
+	_file = NULL;
+	if (!written) {
+		out_error = _error;
+	}
+	return written;
+}
+
+void VyInputRecorder::WriteHeader(int frame, Uint8 kind) {
+	WriteVarint(_buffer, (Uint32)(frame - _recordedFrame));
+	_recordedFrame = frame;
+	_buffer.push_back(kind);
+}
+
+void VyInputRecorder::EndFrame() {
+	// most frames run one update, so only the others are written
+	if (_frame < 0 || _steps == 1) { return; }
+	WriteHeader(_frame, (Uint8)RecordKind::Steps);
+	_buffer.push_back((Uint8)(_steps < 0 ? 0 : _steps > 255 ? 255 : _steps));
+}
+
+bool VyInputRecorder::Flush(std::string& out_error) {
+	if (_buffer.empty()) { return true; }
+	if (SDL_RWwrite(_file, _buffer.data(), 1, _buffer.size()) != _buffer.size()) {
+		out_error = string_format("could not write the recording! SDL Error: %s", SDL_GetError());
+		return false;
+	}
+	_buffer.clear();
+	return true;
+}
+
+bool VyInputReplay::Load(const std::string& path, std::string& out_error) {
+	_events.clear();
+	_frameStarts.clear();
+	_steps.clear();
+	size_t size = 0;
+	Uint8* data = (Uint8*)SDL_LoadFile(path.c_str(), &size);
+	if (data == NULL) {
+		out_error = string_format("could not read %s! SDL Error: %s", path.c_str(), SDL_GetError());
+		return false;
+	}
+	if (size < sizeof(Magic) + 1 || memcmp(data, Magic, sizeof(Magic)) != 0 || data[sizeof(Magic)] != Version) {
+		SDL_free(data);
+		out_error = string_format("%s is not a version %d input recording", path.c_str(), Version);
+		return false;
+	}
+	RecordReader reader(data + sizeof(Magic) + 1, size - sizeof(Magic) - 1);
+	int frame = 0;
+	Uint32 timestamp = 0;
+	bool ended = false;
+	while (!ended && !reader.failed && !reader.IsAtEnd()) {
+		frame += (int)reader.Varint();
+		RecordKind kind = (RecordKind)reader.Byte();
+		if (reader.failed || kind >= RecordKind::Count) { break; }
+		// frames with nothing recorded in them still happened
+		int framesNeeded = kind == RecordKind::End ? frame : frame + 1;
+		while (GetFrameCount() < framesNeeded) {
+			_frameStarts.push_back((Uint32)_events.size());
+			_steps.push_back(1);
+		}
+		if (kind == RecordKind::End) {
+			ended = true;
+			break;
+		}
+		if (kind == RecordKind::Steps) {
+			_steps[frame] = reader.Byte();
+			continue;
+		}
+		SDL_Event e;
+		memset(&e, 0, sizeof(e));
+		timestamp += (Uint32)reader.Signed();
+		switch (kind) {
+		case RecordKind::KeyDown:
+		case RecordKind::KeyUp:
+			e.type = kind == RecordKind::KeyDown ? SDL_KEYDOWN : SDL_KEYUP;
+			e.key.state = kind == RecordKind::KeyDown ? SDL_PRESSED : SDL_RELEASED;
+			e.key.keysym.scancode = (SDL_Scancode)reader.Varint();
+			e.key.keysym.sym = reader.Signed();
+			e.key.keysym.mod = (Uint16)reader.Varint();
+			e.key.repeat = reader.Byte();
+			break;
+		case RecordKind::TextInput: {
+			e.type = SDL_TEXTINPUT;
+			Uint8 length = reader.Byte();
+			for (int i = 0; i < length; ++i) {
+				char c = (char)reader.Byte();
+				if (i < (int)sizeof(e.text.text) - 1) { e.text.text[i] = c; }
+			}
+			break;
+		}
+		case RecordKind::MouseMotion:
+			e.type = SDL_MOUSEMOTION;
+			e.motion.state = reader.Varint();
+			e.motion.x = reader.Signed();
+			e.motion.y = reader.Signed();
+			e.motion.xrel = reader.Signed();
+			e.motion.yrel = reader.Signed();
+			break;
+		case RecordKind::MouseButtonDown:
+		case RecordKind::MouseButtonUp:
+			e.type = kind == RecordKind::MouseButtonDown ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+			e.button.state = kind == RecordKind::MouseButtonDown ? SDL_PRESSED : SDL_RELEASED;
+			e.button.button = reader.Byte();
+			e.button.clicks = reader.Byte();
+			e.button.x = reader.Signed();
+			e.button.y = reader.Signed();
+			break;
+		case RecordKind::MouseWheel:
+			e.type = SDL_MOUSEWHEEL;
+			e.wheel.x = reader.Signed();
+			e.wheel.y = reader.Signed();
+			e.wheel.direction = reader.Varint();
+			break;
+		case RecordKind::Window:
+			e.type = SDL_WINDOWEVENT;
+			e.window.event = reader.Byte();
+			e.window.data1 = reader.Signed();
+			e.window.data2 = reader.Signed();
+			break;
+		default:
+			e.type = SDL_QUIT;
+			break;
+		}
+		e.common.timestamp = timestamp;
+		_events.push_back(e);
+	}
+	SDL_free(data);
+	if (!ended) {
+		out_error = string_format("%s is truncated or corrupt", path.c_str());
+		_events.clear();
+		_frameStarts.clear();
+		_steps.clear();
+		return false;
+	}
+	_frameStarts.push_back((Uint32)_events.size());
+	return true;
+}
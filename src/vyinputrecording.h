@@ -0,0 +1,78 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+/// <summary>
+/// writes the events <see cref="VyEngine::ProcessInput"/> takes from SDL to a compact binary file, frame by frame,
+/// with how many fixed updates each frame ran, so <see cref="VyInputReplay"/> can play the session back exactly.
+/// each record is a varint frame delta, a kind byte, and only the fields of that kind of event, as varints.
+/// events the engine ignores (joystick, touch, drop...) are skipped and counted
+/// </summary>
+class VyInputRecorder {
+private:
+	SDL_RWops* _file;
+	/// <summary>encoded records not yet written, flushed when large and on Stop</summary>
+	std::vector<Uint8> _buffer;
+	/// <summary>the frame being recorded, counted from Start. -1 before the first BeginFrame</summary>
+	int _frame;
+	/// <summary>frame of the last record written, which the next record's delta is from</summary>
+	int _recordedFrame;
+	Uint32 _lastTimestamp;
+	/// <summary>fixed updates of the current frame</summary>
+	int _steps;
+	int _events;
+	int _skipped;
+	/// <summary>from a write while recording, reported by Stop</summary>
+	std::string _error;
+public:
+	VyInputRecorder();
+	~VyInputRecorder();
+	/// <summary>
+	/// creates or truncates the file
+	/// </summary>
+	bool Start(const std::string& path, std::string& out_error);
+	bool IsRecording() const { return _file != NULL; }
+	/// <summary>
+	/// ends the previous frame: events recorded from now on belong to the next one
+	/// </summary>
+	void BeginFrame();
+	void Record(const SDL_Event& e);
+	/// <summary>
+	/// how many fixed updates the current frame ran. 1 unless told otherwise
+	/// </summary>
+	void SetSteps(int steps) { _steps = steps; }
+	/// <summary>
+	/// ends the last frame and closes the file
+	/// </summary>
+	bool Stop(std::string& out_error);
+	int GetFrameCount() const { return _frame + 1; }
+	int GetEventCount() const { return _events; }
+	int GetSkippedCount() const { return _skipped; }
+private:
+	void WriteHeader(int frame, Uint8 kind);
+	void EndFrame();
+	bool Flush(std::string& out_error);
+};
+
+/// <summary>
+/// a recording from <see cref="VyInputRecorder"/>, decoded whole into memory, so playing it back costs nothing but the engine's own work
+/// </summary>
+class VyInputReplay {
+private:
+	std::vector<SDL_Event> _events;
+	/// <summary>per frame, the index of its first event in _events, and one more for the end</summary>
+	std::vector<Uint32> _frameStarts;
+	/// <summary>fixed updates per frame</summary>
+	std::vector<Uint8> _steps;
+public:
+	bool Load(const std::string& path, std::string& out_error);
+	int GetFrameCount() const { return (int)_steps.size(); }
+	int GetEventCount() const { return (int)_events.size(); }
+	/// <returns>the frame's events in the order they were recorded, out_count of them</returns>
+	const SDL_Event* GetEvents(int frame, int& out_count) const {
+		out_count = (int)(_frameStarts[frame + 1] - _frameStarts[frame]);
+		return _events.data() + _frameStarts[frame];
+	}
+	int GetSteps(int frame) const { return _steps[frame]; }
+};
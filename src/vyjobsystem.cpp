@@ -0,0 +1,119 @@
+#include "vyjobsystem.h"
+#include "vyprofiler.h"
+
+VyJobSystem::VyJobSystem(int threadCount) : _queues(), _workers(), _pending(0), _stopping(false), _steals(0) {
+	StartWorkers(threadCount);
+}
+
+VyJobSystem::~VyJobSystem() {
+	StopWorkers();
+}
+
+void VyJobSystem::SetThreadCount(int threadCount) {
+	StopWorkers();
+	StartWorkers(threadCount);
+}
+
+void VyJobSystem::StartWorkers(int threadCount) {
+	if (threadCount <= 0) {
+		threadCount = SDL_GetCPUCount();
+	}
+	if (threadCount < 1) { threadCount = 1; }
+	_stopping = false;
+	for (int i = 0; i < threadCount; ++i) {
+		_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+	}
+	for (int i = 1; i < threadCount; ++i) {
+		_workers.push_back(std::thread(&VyJobSystem::WorkerLoop, this, i));
+	}
+}
+
+void VyJobSystem::StopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_stopping = true;
+	}
+	_wake.notify_all();
+	for (int i = 0; i < _workers.size(); ++i) {
+		_workers[i].join();
+	}
+	_workers.clear();
+	_queues.clear();
+}
+
+void VyJobSystem::ParallelFor(int count, int chunkSize, const RangeJob& body) {
+	if (count <= 0) { return; }
+	if (chunkSize < 1) { chunkSize = 1; }
+	if (_queues.size() == 1 || count <= chunkSize) {
+		body(0, count);
+		return;
+	}
+	VY_PROFILE_ZONE("VyJobSystem::ParallelFor");
+	int chunks = (count + chunkSize - 1) / chunkSize;
+	std::atomic<int> remaining(chunks);
+	// dealt round robin, so every thread starts with its share in its own deque and only steals to even out
+	for (int c = 0; c < chunks; ++c) {
+		WorkQueue& queue = *_queues[c % _queues.size()];
+		int begin = c * chunkSize;
+		Job job = { &body, begin, begin + chunkSize < count ? begin + chunkSize : count, &remaining };
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(job);
+	}
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_pending += chunks;
+	}
+	_wake.notify_all();
+	Job job;
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		if (TakeJob(0, job)) {
+			RunJob(job);
+		} else {
+			// the last chunks are running on other threads
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool VyJobSystem::TakeJob(int queue, Job& out_job) {
+	{
+		WorkQueue& own = *_queues[queue];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty()) {
+			out_job = own.jobs.back();
+			own.jobs.pop_back();
+			--_pending;
+			return true;
+		}
+	}
+	for (int i = 1; i < _queues.size(); ++i) {
+		WorkQueue& victim = *_queues[(queue + i) % _queues.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty()) {
+			out_job = victim.jobs.front();
+			victim.jobs.pop_front();
+			--_pending;
+			++_steals;
+			return true;
+		}
+	}
+	return false;
+}
+
+void VyJobSystem::RunJob(const Job& job) {
+	(*job.body)(job.begin, job.end);
+	job.remaining->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void VyJobSystem::WorkerLoop(int queue) {
+	Job job;
+	while (true) {
+		if (TakeJob(queue, job)) {
+			RunJob(job);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_wake.wait(lock, [this]() { return _stopping || _pending > 0; });
+		if (_stopping) { return; }
+	}
+}
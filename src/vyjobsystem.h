@@ -0,0 +1,70 @@
+#pragma once
+#include <SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary>
+/// a fixed set of worker threads, each with its own deque of jobs. a thread takes work from the back of its own deque,
+/// and when that is empty steals from the front of another's, so uneven chunks even out without a shared queue everyone contends on.
+/// the thread that calls <see cref="VyJobSystem::ParallelFor"/> works too, and it returns only when every chunk is done
+/// </summary>
+class VyJobSystem {
+public:
+	/// <summary>
+	/// called with a range of indices [begin, end)
+	/// </summary>
+	typedef std::function<void(int begin, int end)> RangeJob;
+private:
+	struct Job {
+		const RangeJob* body;
+		int begin, end;
+		std::atomic<int>* remaining;
+	};
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+	/// <summary>one per thread. 0 belongs to whoever calls ParallelFor, the rest to _workers in order</summary>
+	std::vector<std::unique_ptr<WorkQueue>> _queues;
+	std::vector<std::thread> _workers;
+	std::mutex _sleepMutex;
+	std::condition_variable _wake;
+	/// <summary>jobs in any queue, so idle workers know whether to sleep</summary>
+	std::atomic<int> _pending;
+	bool _stopping;
+	std::atomic<int> _steals;
+public:
+	/// <param name="threadCount">threads working on a ParallelFor, counting the caller. 0 uses every CPU</param>
+	VyJobSystem(int threadCount = 0);
+	~VyJobSystem();
+	/// <summary>
+	/// stops and restarts the workers. not while a ParallelFor is running
+	/// </summary>
+	void SetThreadCount(int threadCount);
+	int GetThreadCount() const { return (int)_queues.size(); }
+	/// <summary>
+	/// runs body on chunks of [0, count) of at most chunkSize indices, on every thread, and waits for all of them.
+	/// body must be safe to run on several threads at once. call from one thread at a time, not from inside a job
+	/// </summary>
+	void ParallelFor(int count, int chunkSize, const RangeJob& body);
+	/// <summary>
+	/// jobs taken from another thread's deque since <see cref="VyJobSystem::ResetStats"/>
+	/// </summary>
+	int GetSteals() const { return _steals; }
+	void ResetStats() { _steals = 0; }
+private:
+	void StartWorkers(int threadCount);
+	void StopWorkers();
+	void WorkerLoop(int queue);
+	/// <summary>
+	/// the newest job of the thread's own queue, or failing that the oldest of another's
+	/// </summary>
+	bool TakeJob(int queue, Job& out_job);
+	static void RunJob(const Job& job);
+};
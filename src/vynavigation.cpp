@@ -0,0 +1,291 @@
+#include "vynavigation.h"
+#include "selectablerect.h"
+#include <algorithm>
+#include <climits>
+
+static const Coord AlongStep[] = { Coord(0, -1), Coord(-1, 0), Coord(0, 1), Coord(1, 0) };
+static const Coord AcrossStep[] = { Coord(1, 0), Coord(0, 1), Coord(1, 0), Coord(0, 1) };
+
+static int Opposite(int dir) { return (dir + 2) % 4; }
+
+static long long DistanceSq(const Coord& a, const Coord& b) {
+	long long dx = b.x - a.x, dy = b.y - a.y;
+	return dx * dx + dy * dy;
+}
+
+/// <summary>
+/// up: dy < 0 and |dx| <= |dy|, left: dx < 0 and |dx| >= |dy|, and so on
+/// </summary>
+static bool IsInCone(const Coord& delta, int dir) {
+	int along = delta.x * AlongStep[dir].x + delta.y * AlongStep[dir].y;
+	int across = delta.x * AcrossStep[dir].x + delta.y * AcrossStep[dir].y;
+	return along > 0 && abs(across) <= along;
+}
+
+VyNavigationGraph::VyNavigationGraph(int cellSize) : _cellSize(cellSize) {
+	Clear();
+}
+
+VyNavigationGraph::~VyNavigationGraph() {
+	Clear();
+}
+
+Uint64 VyNavigationGraph::CellKey(int cellX, int cellY) {
+	return ((Uint64)(Uint32)cellX << 32) | (Uint32)cellY;
+}
+
+int VyNavigationGraph::CellOf(int value) const {
+	return value >= 0 ? value / _cellSize : -((-value + _cellSize - 1) / _cellSize);
+}
+
+bool VyNavigationGraph::IsEligible(const SelectableRect* rect) {
+	return rect->_navigatable && rect->_active;
+}
+
+void VyNavigationGraph::Clear() {
+	for (auto it = _ids.begin(); it != _ids.end(); ++it) {
+		it->first->_navigation = NULL;
+	}
+	_nodes.clear();
+	_freeNodes.clear();
+	_ids.clear();
+	_cells.clear();
+	_minCellX = _minCellY = INT_MAX;
+	_maxCellX = _maxCellY = INT_MIN;
+	for (int d = 0; d < DirCount; ++d) {
+		_maxLinkDistanceSq[d] = 0;
+		_unlinked[d].clear();
+	}
+}
+
+void VyNavigationGraph::Insert(int id) {
+	Node& node = _nodes[id];
+	node.center = node.rect->GetCenter();
+	node.cellX = CellOf(node.center.x);
+	node.cellY = CellOf(node.center.y);
+	node.eligible = IsEligible(node.rect);
+	_cells[CellKey(node.cellX, node.cellY)].push_back(id);
+	_minCellX = std::min(_minCellX, node.cellX);
+	_minCellY = std::min(_minCellY, node.cellY);
+	_maxCellX = std::max(_maxCellX, node.cellX);
+	_maxCellY = std::max(_maxCellY, node.cellY);
+}
+
+void VyNavigationGraph::Erase(int id) {
+	const Node& node = _nodes[id];
+	auto found = _cells.find(CellKey(node.cellX, node.cellY));
+	if (found == _cells.end()) { return; }
+	std::vector<int>& cell = found->second;
+	auto it = std::find(cell.begin(), cell.end(), id);
+	if (it != cell.end()) {
+		*it = cell.back();
+		cell.pop_back();
+	}
+	if (cell.empty()) {
+		_cells.erase(found);
+	}
+}
+
+template<typename Visit>
+void VyNavigationGraph::WalkCone(int id, int dir, Visit visit) const {
+	const Node& self = _nodes[id];
+	Coord along = AlongStep[dir], across = AcrossStep[dir];
+	long long stopDistanceSq = -1;
+	for (int k = 0; ; ++k) {
+		// centers k rows away are at least (k-1) cells + 1 pixel away along the cone
+		if (k > 0 && stopDistanceSq >= 0) {
+			long long nearest = (long long)(k - 1) * _cellSize + 1;
+			if (nearest * nearest > stopDistanceSq) { return; }
+		}
+		int rowX = self.cellX + along.x * k, rowY = self.cellY + along.y * k;
+		if (rowX < _minCellX || rowX > _maxCellX || rowY < _minCellY || rowY > _maxCellY) { return; }
+		// the cone is as wide as it is far, so row k only needs k+1 cells to each side
+		for (int j = -(k + 1); j <= k + 1; ++j) {
+			int cx = rowX + across.x * j, cy = rowY + across.y * j;
+			if (cx < _minCellX || cx > _maxCellX || cy < _minCellY || cy > _maxCellY) { continue; }
+			auto found = _cells.find(CellKey(cx, cy));
+			if (found == _cells.end()) { continue; }
+			const std::vector<int>& cell = found->second;
+			for (int i = 0; i < cell.size(); ++i) {
+				stopDistanceSq = visit(cell[i]);
+			}
+		}
+	}
+}
+
+bool VyNavigationGraph::IsCloser(const Coord& from, int a, int b) const {
+	if (b < 0) { return true; }
+	long long da = DistanceSq(from, _nodes[a].center), db = DistanceSq(from, _nodes[b].center);
+	return da < db || (da == db && a < b);
+}
+
+int VyNavigationGraph::FindBest(int id, int dir) const {
+	const Coord& from = _nodes[id].center;
+	int best = -1;
+	WalkCone(id, dir, [&](int candidate) -> long long {
+		const Node& node = _nodes[candidate];
+		if (candidate != id && node.eligible && IsInCone(node.center - from, dir) && IsCloser(from, candidate, best)) {
+			best = candidate;
+		}
+		return best < 0 ? -1 : DistanceSq(from, _nodes[best].center);
+	});
+	return best;
+}
+
+void VyNavigationGraph::SetLink(int id, int dir, int target) {
+	Node& node = _nodes[id];
+	int old = node.link[dir];
+	if (target >= 0) {
+		// also when the link stays, since this node may have moved further from it
+		_maxLinkDistanceSq[dir] = std::max(_maxLinkDistanceSq[dir], DistanceSq(node.center, _nodes[target].center));
+	}
+	if (old == target) { return; }
+	if (old >= 0) {
+		std::vector<int>& referrers = _nodes[old].referrers;
+		auto it = std::find(referrers.begin(), referrers.end(), id);
+		if (it != referrers.end()) {
+			*it = referrers.back();
+			referrers.pop_back();
+		}
+	}
+	node.link[dir] = target;
+	if (target >= 0) {
+		_nodes[target].referrers.push_back(id);
+		_unlinked[dir].erase(id);
+	} else {
+		_unlinked[dir].insert(id);
+	}
+	node.rect->SetNavigation((Rect::Dir)dir, target >= 0 ? _nodes[target].rect : NULL);
+}
+
+void VyNavigationGraph::Relink(int id) {
+	for (int d = 0; d < DirCount; ++d) {
+		SetLink(id, d, FindBest(id, d));
+	}
+}
+
+void VyNavigationGraph::RelinkReferrers(int id) {
+	std::vector<int> referrers = _nodes[id].referrers;
+	for (int i = 0; i < referrers.size(); ++i) {
+		int referrer = referrers[i];
+		for (int d = 0; d < DirCount; ++d) {
+			if (_nodes[referrer].link[d] == id) {
+				SetLink(referrer, d, FindBest(referrer, d));
+			}
+		}
+	}
+}
+
+void VyNavigationGraph::OfferAsTarget(int id) {
+	const Coord& center = _nodes[id].center;
+	for (int d = 0; d < DirCount; ++d) {
+		// whoever has this center in their cone d is in this node's opposite cone
+		long long reach = _maxLinkDistanceSq[d];
+		WalkCone(id, Opposite(d), [&](int other) -> long long {
+			const Node& node = _nodes[other];
+			if (other != id && IsInCone(center - node.center, d) && IsCloser(node.center, id, node.link[d])) {
+				SetLink(other, d, id);
+			}
+			return reach;
+		});
+		std::vector<int> unlinked(_unlinked[d].begin(), _unlinked[d].end());
+		for (int i = 0; i < unlinked.size(); ++i) {
+			int other = unlinked[i];
+			if (other != id && IsInCone(center - _nodes[other].center, d)) {
+				SetLink(other, d, id);
+			}
+		}
+	}
+}
+
+void VyNavigationGraph::Build(const std::vector<SelectableRect*>& rects) {
+	// like Add, a rect leaves the graph it was in, which would otherwise keep linking to it
+	for (SelectableRect* rect : rects) {
+		if (rect->_navigation != NULL && rect->_navigation != this) {
+			rect->_navigation->Remove(rect);
+		}
+	}
+	Clear();
+	_nodes.resize(rects.size());
+	for (int id = 0; id < rects.size(); ++id) {
+		Node& node = _nodes[id];
+		node.rect = rects[id];
+		for (int d = 0; d < DirCount; ++d) {
+			node.link[d] = -1;
+			_unlinked[d].insert(id);
+		}
+		node.rect->ClearNavigation();
+		node.rect->_navigation = this;
+		_ids[node.rect] = id;
+		Insert(id);
+	}
+	for (int id = 0; id < _nodes.size(); ++id) {
+		Relink(id);
+	}
+}
+
+void VyNavigationGraph::Add(SelectableRect* rect) {
+	if (_ids.find(rect) != _ids.end()) {
+		Update(rect);
+		return;
+	}
+	if (rect->_navigation != NULL) {
+		rect->_navigation->Remove(rect);
+	}
+	int id;
+	if (!_freeNodes.empty()) {
+		id = _freeNodes.back();
+		_freeNodes.pop_back();
+	} else {
+		id = (int)_nodes.size();
+		_nodes.emplace_back();
+	}
+	Node& node = _nodes[id];
+	node.rect = rect;
+	node.referrers.clear();
+	for (int d = 0; d < DirCount; ++d) {
+		node.link[d] = -1;
+		_unlinked[d].insert(id);
+	}
+	rect->ClearNavigation();
+	rect->_navigation = this;
+	_ids[rect] = id;
+	Insert(id);
+	Relink(id);
+	if (_nodes[id].eligible) {
+		OfferAsTarget(id);
+	}
+}
+
+void VyNavigationGraph::Update(SelectableRect* rect) {
+	auto found = _ids.find(rect);
+	if (found == _ids.end()) { return; }
+	int id = found->second;
+	Node& node = _nodes[id];
+	if (node.center == rect->GetCenter() && node.eligible == IsEligible(rect)) { return; }
+	Erase(id);
+	Insert(id);
+	Relink(id);
+	RelinkReferrers(id);
+	if (_nodes[id].eligible) {
+		OfferAsTarget(id);
+	}
+}
+
+void VyNavigationGraph::Remove(SelectableRect* rect) {
+	auto found = _ids.find(rect);
+	if (found == _ids.end()) { return; }
+	int id = found->second;
+	Erase(id);
+	_nodes[id].eligible = false;
+	for (int d = 0; d < DirCount; ++d) {
+		SetLink(id, d, -1);
+		_unlinked[d].erase(id);
+	}
+	RelinkReferrers(id);
+	rect->_navigation = NULL;
+	_nodes[id].rect = NULL;
+	_nodes[id].referrers.clear();
+	_ids.erase(found);
+	_freeNodes.push_back(id);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "rect.h"
+
+class SelectableRect;
+
+/// <summary>
+/// keeps up/left/down/right navigation links between <see cref="SelectableRect"/>s, using a uniform grid of rect centers.
+/// a link goes to the nearest navigatable, active center inside the 90 degree cone in that direction (same rule as the original SetupNavigation).
+/// searches walk rows of cells outward from the rect and stop once no closer center is possible, so building is about O(N) for menus and grids,
+/// and moving, (de)activating or toggling one rect only revisits its own links, the rects linking to it, and the rects it could now be closer to
+/// </summary>
+class VyNavigationGraph {
+private:
+	static const int DirCount = (int)Rect::Dir::Count;
+	struct Node {
+		SelectableRect* rect;
+		Coord center;
+		int cellX, cellY;
+		/// <summary>navigatable and active: can be linked to</summary>
+		bool eligible;
+		int link[DirCount];
+		/// <summary>nodes linking here, once per link</summary>
+		std::vector<int> referrers;
+	};
+	int _cellSize;
+	std::vector<Node> _nodes;
+	std::vector<int> _freeNodes;
+	std::unordered_map<SelectableRect*, int> _ids;
+	std::unordered_map<Uint64, std::vector<int>> _cells;
+	/// <summary>cell bounds of every center ever added since the last <see cref="VyNavigationGraph::Clear"/>. may be loose</summary>
+	int _minCellX, _minCellY, _maxCellX, _maxCellY;
+	/// <summary>longest link per direction since the last <see cref="VyNavigationGraph::Clear"/>, bounds how far a new center can steal links</summary>
+	long long _maxLinkDistanceSq[DirCount];
+	/// <summary>nodes with nothing in a direction, which any new center in that direction takes</summary>
+	std::unordered_set<int> _unlinked[DirCount];
+public:
+	VyNavigationGraph(int cellSize = 64);
+	~VyNavigationGraph();
+	/// <summary>
+	/// replaces the graph with these rects and links them all. ties go to the earlier rect, like the original SetupNavigation
+	/// </summary>
+	void Build(const std::vector<SelectableRect*>& rects);
+	void Add(SelectableRect* rect);
+	/// <summary>
+	/// call after the rect moved, or its active/navigatable state changed. <see cref="SelectableRect"/> does this itself when in a graph
+	/// </summary>
+	void Update(SelectableRect* rect);
+	void Remove(SelectableRect* rect);
+	/// <summary>
+	/// removes every rect, leaving their links as they are
+	/// </summary>
+	void Clear();
+	int GetCount() const { return (int)_ids.size(); }
+private:
+	static Uint64 CellKey(int cellX, int cellY);
+	int CellOf(int value) const;
+	static bool IsEligible(const SelectableRect* rect);
+	void Insert(int id);
+	void Erase(int id);
+	int FindBest(int id, int dir) const;
+	void Relink(int id);
+	void RelinkReferrers(int id);
+	void OfferAsTarget(int id);
+	void SetLink(int id, int dir, int target);
+	/// <returns>true if candidate a is a better link than b, for a node at from</returns>
+	bool IsCloser(const Coord& from, int a, int b) const;
+	/// <summary>
+	/// calls visit(id) for every node in the cells that may hold centers in the cone dir of node id, nearest rows first.
+	/// visit returns the squared distance beyond which the walk can stop (or -1 to keep going)
+	/// </summary>
+	template<typename Visit>
+	void WalkCone(int id, int dir, Visit visit) const;
+};
@@ -12,4 +12,5 @@ public:
 	virtual VyEventProcessor* AsEventProcessor() { return nullptr; }
 	virtual VyDrawable* AsDrawable() { return nullptr; }
 	virtual VyUpdatable* AsUpdatable() { return nullptr; }
+	virtual HasRect* AsRect() { return nullptr; }
 };
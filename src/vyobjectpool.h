@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include <utility>
+
+/// <summary>
+/// fixed-size blocks carved out of large chunks, with freed blocks kept on an intrusive free list: allocate and free are O(1),
+/// and blocks never move, since chunks are only released with the storage.
+/// the block size is set by the first allocation, which for a <see cref="VyObjectPool"/> is always the same shared_ptr control block.
+/// single threaded, like the rest of the engine's object lifetime
+/// </summary>
+class VyPoolStorage {
+private:
+	struct FreeBlock { FreeBlock* next; };
+	std::vector<std::unique_ptr<unsigned char[]>> _chunks;
+	FreeBlock* _free;
+	size_t _blockSize;
+	int _blocksPerChunk;
+	int _live;
+	int _capacity;
+public:
+	VyPoolStorage(int blocksPerChunk) : _chunks(), _free(NULL), _blockSize(0), _blocksPerChunk(blocksPerChunk), _live(0), _capacity(0) {}
+	/// <summary>
+	/// anything other than one block of at most the pool's block size goes to the global allocator
+	/// </summary>
+	void* Allocate(size_t bytes, size_t count) {
+		if (_blockSize == 0 && count == 1) {
+			_blockSize = RoundUp(bytes < sizeof(FreeBlock) ? sizeof(FreeBlock) : bytes);
+		}
+		if (count != 1 || bytes > _blockSize) {
+			return ::operator new(bytes * count);
+		}
+		if (_free == NULL) {
+			AddChunk();
+		}
+		FreeBlock* block = _free;
+		_free = block->next;
+		++_live;
+		return block;
+	}
+	void Free(void* block, size_t bytes, size_t count) {
+		if (count != 1 || bytes > _blockSize) {
+			::operator delete(block);
+			return;
+		}
+		FreeBlock* freed = (FreeBlock*)block;
+		freed->next = _free;
+		_free = freed;
+		--_live;
+	}
+	int GetLiveCount() const { return _live; }
+	int GetCapacity() const { return _capacity; }
+	size_t GetBlockSize() const { return _blockSize; }
+private:
+	static size_t RoundUp(size_t bytes) {
+		const size_t align = alignof(std::max_align_t);
+		return (bytes + align - 1) / align * align;
+	}
+	void AddChunk() {
+		// operator new[] memory is aligned for any fundamental type, and every block size is a multiple of that alignment
+		_chunks.push_back(std::unique_ptr<unsigned char[]>(new unsigned char[_blockSize * _blocksPerChunk]));
+		unsigned char* chunk = _chunks.back().get();
+		for (int i = _blocksPerChunk - 1; i >= 0; --i) {
+			FreeBlock* block = (FreeBlock*)(chunk + _blockSize * i);
+			block->next = _free;
+			_free = block;
+		}
+		_capacity += _blocksPerChunk;
+	}
+};
+
+/// <summary>
+/// standard allocator over a <see cref="VyPoolStorage"/>. copies, including rebinds, share the storage and keep it alive,
+/// so objects can outlive the pool that made them
+/// </summary>
+template<typename T>
+class VyPoolAllocator {
+public:
+	typedef T value_type;
+	std::shared_ptr<VyPoolStorage> storage;
+	VyPoolAllocator(std::shared_ptr<VyPoolStorage> storage) : storage(storage) {}
+	template<typename U>
+	VyPoolAllocator(const VyPoolAllocator<U>& other) : storage(other.storage) {}
+	T* allocate(size_t count) { return (T*)storage->Allocate(sizeof(T), count); }
+	void deallocate(T* block, size_t count) { storage->Free(block, sizeof(T), count); }
+	template<typename U>
+	bool operator==(const VyPoolAllocator<U>& other) const { return storage == other.storage; }
+	template<typename U>
+	bool operator!=(const VyPoolAllocator<U>& other) const { return storage != other.storage; }
+};
+
+/// <summary>
+/// makes shared_ptrs of T whose object and reference counts share one pooled block, instead of the two global allocations of shared_ptr(new T).
+/// spawning takes a free block, and the last reference going away returns it. addresses are stable for the object's lifetime
+/// </summary>
+template<typename T>
+class VyObjectPool {
+private:
+	std::shared_ptr<VyPoolStorage> _storage;
+public:
+	VyObjectPool(int blocksPerChunk = 64) : _storage(std::make_shared<VyPoolStorage>(blocksPerChunk)) {}
+	template<typename... Args>
+	std::shared_ptr<T> Spawn(Args&&... args) {
+		return std::allocate_shared<T>(VyPoolAllocator<T>(_storage), std::forward<Args>(args)...);
+	}
+	int GetLiveCount() const { return _storage->GetLiveCount(); }
+	int GetCapacity() const { return _storage->GetCapacity(); }
+	/// <summary>
+	/// one pool per type for the whole program, used by <see cref="VyComponentContainer::AddComponent"/>. main thread only
+	/// </summary>
+	static VyObjectPool<T>& GetShared() {
+		static VyObjectPool<T> pool;
+		return pool;
+	}
+};
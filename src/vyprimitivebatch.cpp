@@ -0,0 +1,124 @@
+#include "vyprimitivebatch.h"
+#include <cmath>
+#include <algorithm>
+#include "vyprofiler.h"
+
+VyPrimitiveBatch::VyPrimitiveBatch(SDL_Renderer* renderer) : _renderer(renderer), _buckets(), _bucketCount(0), _current(-1), _color({ 0xFF, 0xFF, 0xFF, 0xFF }),
+_vertices(), _indices(), _drawCalls(0), _offset({ 0, 0 }) {
+	_vertices.reserve(4 * 64);
+	_indices.reserve(6 * 64);
+}
+
+void VyPrimitiveBatch::SetRenderer(SDL_Renderer* renderer) {
+	if (renderer == _renderer) { return; }
+	Flush();
+	_renderer = renderer;
+}
+
+void VyPrimitiveBatch::SetColor(SDL_Color color) {
+	if (color.r == _color.r && color.g == _color.g && color.b == _color.b && color.a == _color.a) { return; }
+	_color = color;
+	_current = -1;
+}
+
+VyPrimitiveBatch::Bucket& VyPrimitiveBatch::CurrentBucket() {
+	if (_current >= 0) {
+		return _buckets[_current];
+	}
+	for (int i = 0; i < _bucketCount; ++i) {
+		const SDL_Color& c = _buckets[i].color;
+		if (c.r == _color.r && c.g == _color.g && c.b == _color.b && c.a == _color.a) {
+			_current = i;
+			return _buckets[i];
+		}
+	}
+	if (_bucketCount == MaxColors) {
+		Flush();
+	}
+	if (_bucketCount == _buckets.size()) {
+		_buckets.push_back(Bucket());
+	}
+	_current = _bucketCount++;
+	_buckets[_current].color = _color;
+	return _buckets[_current];
+}
+
+void VyPrimitiveBatch::FillRect(const SDL_Rect& rect) {
+	CurrentBucket().rects.push_back({ rect.x + _offset.x, rect.y + _offset.y, rect.w, rect.h });
+}
+
+void VyPrimitiveBatch::FillSpan(int x0, int x1, int y) {
+	if (x0 > x1) { std::swap(x0, x1); }
+	CurrentBucket().rects.push_back({ x0 + _offset.x, y + _offset.y, x1 - x0 + 1, 1 });
+}
+
+void VyPrimitiveBatch::FillColumn(int x, int y0, int y1) {
+	if (y0 > y1) { std::swap(y0, y1); }
+	CurrentBucket().rects.push_back({ x + _offset.x, y0 + _offset.y, 1, y1 - y0 + 1 });
+}
+
+void VyPrimitiveBatch::Point(int x, int y) {
+	CurrentBucket().points.push_back({ x + _offset.x, y + _offset.y });
+}
+
+void VyPrimitiveBatch::Line(int x0, int y0, int x1, int y1) {
+	if (y0 == y1) {
+		FillSpan(x0, x1, y0);
+	} else if (x0 == x1) {
+		FillColumn(x0, y0, y1);
+	} else {
+		AppendLineQuad(_vertices, _indices, (float)(x0 + _offset.x), (float)(y0 + _offset.y), (float)(x1 + _offset.x), (float)(y1 + _offset.y), _color);
+	}
+}
+
+void VyPrimitiveBatch::AppendLineQuad(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices, float x0, float y0, float x1, float y1, SDL_Color color) {
+	float dx = x1 - x0, dy = y1 - y0;
+	float length = std::sqrt(dx * dx + dy * dy);
+	if (length == 0) {
+		dx = 1; dy = 0;
+	} else {
+		dx /= length; dy /= length;
+	}
+	// corners are the ends, pushed half a pixel along the line and half a pixel to either side of it
+	float ax = (dx - dy) * 0.5f, ay = (dy + dx) * 0.5f;
+	float bx = (dx + dy) * 0.5f, by = (dy - dx) * 0.5f;
+	float sx = x0 + 0.5f, sy = y0 + 0.5f, ex = x1 + 0.5f, ey = y1 + 0.5f;
+	int first = (int)vertices.size();
+	vertices.push_back({ { sx - ax, sy - ay }, color, { 0, 0 } });
+	vertices.push_back({ { ex + bx, ey + by }, color, { 0, 0 } });
+	vertices.push_back({ { ex + ax, ey + ay }, color, { 0, 0 } });
+	vertices.push_back({ { sx - bx, sy - by }, color, { 0, 0 } });
+	int quad[] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+	indices.insert(indices.end(), quad, quad + 6);
+}
+
+void VyPrimitiveBatch::Flush() {
+	if (IsEmpty()) { return; }
+	VY_PROFILE_ZONE("VyPrimitiveBatch::Flush");
+	Uint8 r, g, b, a;
+	SDL_GetRenderDrawColor(_renderer, &r, &g, &b, &a);
+	for (int i = 0; i < _bucketCount; ++i) {
+		Bucket& bucket = _buckets[i];
+		SDL_SetRenderDrawColor(_renderer, bucket.color.r, bucket.color.g, bucket.color.b, bucket.color.a);
+		if (!bucket.rects.empty()) {
+			SDL_RenderFillRects(_renderer, bucket.rects.data(), (int)bucket.rects.size());
+			++_drawCalls;
+			bucket.rects.clear();
+		}
+		if (!bucket.points.empty()) {
+			SDL_RenderDrawPoints(_renderer, bucket.points.data(), (int)bucket.points.size());
+			++_drawCalls;
+			bucket.points.clear();
+		}
+	}
+	SDL_SetRenderDrawColor(_renderer, r, g, b, a);
+	if (!_indices.empty()) {
+		// colors are in the vertices, so lines of every color go in one call
+		SDL_RenderGeometry(_renderer, NULL, _vertices.data(), (int)_vertices.size(), _indices.data(), (int)_indices.size());
+		++_drawCalls;
+		_vertices.clear();
+		_indices.clear();
+	}
+	_bucketCount = 0;
+	_current = -1;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+/// <summary>
+/// collects untextured rects, points and lines, and draws them with one SDL_RenderFillRects and one SDL_RenderDrawPoints per color,
+/// plus one SDL_RenderGeometry for all diagonal lines. axis-aligned lines become rects.
+/// primitives are drawn grouped by kind and color rather than in the order added, so use one batch for things that don't overdraw each other
+/// </summary>
+class VyPrimitiveBatch {
+private:
+	struct Bucket {
+		SDL_Color color;
+		std::vector<SDL_Rect> rects;
+		std::vector<SDL_Point> points;
+	};
+	SDL_Renderer* _renderer;
+	/// <summary>kept allocated between flushes, only the first _bucketCount are in use</summary>
+	std::vector<Bucket> _buckets;
+	int _bucketCount;
+	/// <summary>bucket of the current color, or -1 until something is added in it</summary>
+	int _current;
+	SDL_Color _color;
+	std::vector<SDL_Vertex> _vertices;
+	std::vector<int> _indices;
+	int _drawCalls;
+	SDL_Point _offset;
+public:
+	/// <summary>colors per flush. one more flushes first</summary>
+	static const int MaxColors = 16;
+	VyPrimitiveBatch(SDL_Renderer* renderer);
+	/// <summary>
+	/// added to everything drawn from now on, the camera's <see cref="VyCamera::GetDrawOffset"/> while <see cref="VyEngine::Render"/> runs
+	/// </summary>
+	void SetOffset(SDL_Point offset) { _offset = offset; }
+	SDL_Point GetOffset() const { return _offset; }
+	/// <summary>
+	/// flushes anything pending for the previous renderer
+	/// </summary>
+	void SetRenderer(SDL_Renderer* renderer);
+	SDL_Renderer* GetRenderer() const { return _renderer; }
+	void SetColor(SDL_Color color);
+	/// <summary>
+	/// the packed colors used with SDL_SetRenderDrawColor(SDL_Renderer*, long)
+	/// </summary>
+	void SetColor(long rgba) {
+		Uint8* c = (Uint8*)&rgba;
+		SetColor({ c[0], c[1], c[2], c[3] });
+	}
+	SDL_Color GetColor() const { return _color; }
+	void FillRect(const SDL_Rect& rect);
+	/// <summary>
+	/// the pixels from x0 to x1 (either order, both included) on row y, like a horizontal SDL_RenderDrawLine
+	/// </summary>
+	void FillSpan(int x0, int x1, int y);
+	/// <summary>
+	/// the pixels from y0 to y1 (either order, both included) in column x
+	/// </summary>
+	void FillColumn(int x, int y0, int y1);
+	void Point(int x, int y);
+	/// <summary>
+	/// like SDL_RenderDrawLine
+	/// </summary>
+	void Line(int x0, int y0, int x1, int y1);
+	bool IsEmpty() const { return _bucketCount == 0 && _indices.empty(); }
+	/// <summary>
+	/// draws everything, then restores the renderer's draw color
+	/// </summary>
+	void Flush();
+	/// <summary>
+	/// SDL draw calls since <see cref="VyPrimitiveBatch::ResetStats"/>
+	/// </summary>
+	int GetDrawCalls() const { return _drawCalls; }
+	void ResetStats() { _drawCalls = 0; }
+	/// <summary>
+	/// a one pixel wide quad through pixel centers, reaching half a pixel past each end like SDL_RenderDrawLine
+	/// </summary>
+	static void AppendLineQuad(std::vector<SDL_Vertex>& vertices, std::vector<int>& indices, float x0, float y0, float x1, float y1, SDL_Color color);
+private:
+	Bucket& CurrentBucket();
+};
@@ -0,0 +1,97 @@
+#include "vyprofiler.h"
+#ifdef VY_PROFILE
+#include <stdio.h>
+
+VyProfiler& VyProfiler::GetInstance() {
+	static VyProfiler* instance = new VyProfiler();
+	return *instance;
+}
+
+VyProfiler::VyProfiler() : _written(0), _counterCount(0) {
+	_origin = SDL_GetPerformanceCounter();
+	_frameStart = _origin;
+	_frequency = SDL_GetPerformanceFrequency();
+}
+
+Uint32 VyProfiler::GetThreadIndex() {
+	static std::atomic<Uint32> nextThread(0);
+	thread_local Uint32 threadIndex = nextThread++;
+	return threadIndex;
+}
+
+void VyProfiler::Push(const Event& e) {
+	Uint64 index = _written.fetch_add(1, std::memory_order_relaxed);
+	_events[index & (Capacity - 1)] = e;
+}
+
+void VyProfiler::RecordZone(const char* name, Uint64 start, Uint64 end) {
+	Push({ name, start, (Sint64)(end - start), EventKind::Zone, GetThreadIndex() });
+}
+
+void VyProfiler::AddCounter(const char* name, Sint64 value) {
+	for (int i = 0; i < _counterCount; ++i) {
+		if (_counters[i].name == name) {
+			_counters[i].value += value;
+			return;
+		}
+	}
+	if (_counterCount < MaxCounters) {
+		_counters[_counterCount++] = { name, value };
+	}
+}
+
+void VyProfiler::EndFrame() {
+	Uint64 now = SDL_GetPerformanceCounter();
+	Push({ "Frame", _frameStart, (Sint64)(now - _frameStart), EventKind::Frame, GetThreadIndex() });
+	for (int i = 0; i < _counterCount; ++i) {
+		Push({ _counters[i].name, now, _counters[i].value, EventKind::Counter, 0 });
+		_counters[i].value = 0;
+	}
+	_frameStart = now;
+}
+
+static void WriteJsonString(FILE* file, const char* text) {
+	fputc('"', file);
+	for (const char* c = text; *c != '\0'; ++c) {
+		switch (*c) {
+		case '"': fputs("\\\"", file); break;
+		case '\\': fputs("\\\\", file); break;
+		default:
+			if ((unsigned char)*c >= 0x20) { fputc(*c, file); }
+			break;
+		}
+	}
+	fputc('"', file);
+}
+
+bool VyProfiler::WriteChromeTrace(const std::string& path) {
+	FILE* file = fopen(path.c_str(), "w");
+	if (file == NULL) {
+		return false;
+	}
+	Uint64 written = _written.load(std::memory_order_acquire);
+	Uint64 first = written > Capacity ? written - Capacity : 0;
+	double toMicroseconds = 1000000.0 / _frequency;
+	fputs("{\"traceEvents\":[\n", file);
+	for (Uint64 i = first; i < written; ++i) {
+		const Event& e = _events[i & (Capacity - 1)];
+		double ts = (Sint64)(e.start - _origin) * toMicroseconds;
+		if (i != first) { fputs(",\n", file); }
+		fputs("{\"name\":", file);
+		WriteJsonString(file, e.name);
+		switch (e.kind) {
+		case EventKind::Zone:
+		case EventKind::Frame:
+			fprintf(file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+				e.kind == EventKind::Frame ? "frame" : "zone", ts, e.value * toMicroseconds, e.thread);
+			break;
+		case EventKind::Counter:
+			fprintf(file, ",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"value\":%lld}}", ts, (long long)e.value);
+			break;
+		}
+	}
+	fputs("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+	fclose(file);
+	return true;
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+// Built-in hot-path instrumentation. Define VY_PROFILE (project preprocessor definitions) to enable.
+// Without VY_PROFILE every macro below expands to nothing, and vyprofiler.cpp is empty.
+//
+//   VY_PROFILE_ZONE("name")           times the enclosing scope. name must outlive the profiler (literal or typeid name)
+//   VY_PROFILE_COUNTER("name", value) adds value to a per-frame counter, emitted and reset by VY_PROFILE_FRAME
+//   VY_PROFILE_FRAME()                marks the end of a frame
+//   VY_PROFILE_DUMP("trace.json")     writes the ring buffer as a Chrome trace_event file (chrome://tracing, ui.perfetto.dev)
+
+#ifdef VY_PROFILE
+#include <SDL.h>
+#include <atomic>
+#include <string>
+
+class VyProfiler {
+public:
+	enum class EventKind : Uint8 { Zone, Counter, Frame };
+	struct Event {
+		const char* name;
+		Uint64 start;
+		/// <summary>duration in performance counter ticks for zones, value for counters</summary>
+		Sint64 value;
+		EventKind kind;
+		Uint32 thread;
+	};
+	static const int Capacity = 1 << 16;
+	static const int MaxCounters = 32;
+private:
+	struct Counter {
+		const char* name;
+		Sint64 value;
+	};
+	Event _events[Capacity];
+	std::atomic<Uint64> _written;
+	Counter _counters[MaxCounters];
+	int _counterCount;
+	Uint64 _origin;
+	Uint64 _frameStart;
+	Uint64 _frequency;
+	VyProfiler();
+public:
+	static VyProfiler& GetInstance();
+	static Uint32 GetThreadIndex();
+	void RecordZone(const char* name, Uint64 start, Uint64 end);
+	void AddCounter(const char* name, Sint64 value);
+	void EndFrame();
+	/// <returns>false if the file could not be written</returns>
+	bool WriteChromeTrace(const std::string& path);
+	Uint64 GetEventCount() const { return _written.load(std::memory_order_relaxed); }
+private:
+	void Push(const Event& e);
+};
+
+class VyProfileZone {
+private:
+	const char* _name;
+	VyProfiler& _profiler;
+	Uint64 _start;
+public:
+	VyProfileZone(const char* name) : _name(name), _profiler(VyProfiler::GetInstance()), _start(SDL_GetPerformanceCounter()) {}
+	~VyProfileZone() { _profiler.RecordZone(_name, _start, SDL_GetPerformanceCounter()); }
+};
+
+#define VY_PROFILE_CONCAT_INNER(a, b) a##b
+#define VY_PROFILE_CONCAT(a, b) VY_PROFILE_CONCAT_INNER(a, b)
+#define VY_PROFILE_ZONE(name) VyProfileZone VY_PROFILE_CONCAT(_vyProfileZone, __LINE__)(name)
+#define VY_PROFILE_COUNTER(name, value) VyProfiler::GetInstance().AddCounter(name, value)
+#define VY_PROFILE_FRAME() VyProfiler::GetInstance().EndFrame()
+#define VY_PROFILE_DUMP(path) VyProfiler::GetInstance().WriteChromeTrace(path)
+#else
+#define VY_PROFILE_ZONE(name)
+#define VY_PROFILE_COUNTER(name, value)
+#define VY_PROFILE_FRAME()
+#define VY_PROFILE_DUMP(path) false
+#endif
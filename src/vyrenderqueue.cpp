@@ -0,0 +1,176 @@
+#include "vyrenderqueue.h"
+#include <algorithm>
+#include "vyatlas.h"
+#include "vyprimitivebatch.h"
+#include "vyprofiler.h"
+
+static const Uint64 IndexBits = 20;
+static const Uint64 IndexMask = ((Uint64)1 << IndexBits) - 1;
+static const Uint64 BlendShift = IndexBits;
+static const Uint64 TextureShift = BlendShift + 4;
+static const Uint64 TextureMask = ((Uint64)1 << 12) - 1;
+static const Uint64 OrderShift = TextureShift + 12;
+static const Uint64 LayerShift = OrderShift + 16;
+
+/// <summary>
+/// small number per blend mode, for the sort key. custom modes share one number; Flush still separates them
+/// </summary>
+static Uint64 BlendOrder(SDL_BlendMode blend) {
+	switch (blend) {
+	case SDL_BLENDMODE_NONE: return 0;
+	case SDL_BLENDMODE_BLEND: return 1;
+	case SDL_BLENDMODE_ADD: return 2;
+	case SDL_BLENDMODE_MOD: return 3;
+	default: return 4;
+	}
+}
+
+VyRenderQueue::VyRenderQueue(SDL_Renderer* renderer) : _renderer(renderer), _commands(), _keys(), _textureOrder(), _vertices(), _indices(),
+_drawCalls(0), _commandCount(0), _offset({ 0, 0 }), _order(0) {
+	_commands.reserve(1024);
+	_keys.reserve(1024);
+	_vertices.reserve(4 * 256);
+	_indices.reserve(6 * 256);
+}
+
+VyRenderCommand& VyRenderQueue::Add(VyRenderCommand::Kind kind, SDL_Texture* texture, SDL_BlendMode blend, int layer) {
+	if (_commands.size() > IndexMask) {
+		Flush();
+	}
+	Uint32 textureOrder = 0;
+	if (texture != NULL) {
+		auto found = _textureOrder.find(texture);
+		if (found == _textureOrder.end()) {
+			textureOrder = (Uint32)std::min((Uint64)_textureOrder.size() + 1, TextureMask);
+			_textureOrder[texture] = textureOrder;
+		} else {
+			textureOrder = found->second;
+		}
+	}
+	layer = std::max(-MaxLayer, std::min(layer, MaxLayer)) + MaxLayer;
+	_keys.push_back(((Uint64)layer << LayerShift) | ((Uint64)_order << OrderShift) | ((Uint64)textureOrder << TextureShift) | (BlendOrder(blend) << BlendShift) | (Uint64)_commands.size());
+	_commands.push_back(VyRenderCommand());
+	VyRenderCommand& command = _commands.back();
+	command.kind = kind;
+	command.texture = texture;
+	command.blend = blend;
+	return command;
+}
+
+void VyRenderQueue::FillRect(const SDL_Rect& rect, SDL_Color color, int layer, SDL_BlendMode blend) {
+	VyRenderCommand& command = Add(VyRenderCommand::Kind::FillRect, NULL, blend, layer);
+	command.color = color;
+	command.x0 = (float)(rect.x + _offset.x);
+	command.y0 = (float)(rect.y + _offset.y);
+	command.x1 = (float)(rect.x + rect.w + _offset.x);
+	command.y1 = (float)(rect.y + rect.h + _offset.y);
+}
+
+void VyRenderQueue::Line(int x0, int y0, int x1, int y1, SDL_Color color, int layer, SDL_BlendMode blend) {
+	VyRenderCommand& command = Add(VyRenderCommand::Kind::Line, NULL, blend, layer);
+	command.color = color;
+	command.x0 = (float)(x0 + _offset.x);
+	command.y0 = (float)(y0 + _offset.y);
+	command.x1 = (float)(x1 + _offset.x);
+	command.y1 = (float)(y1 + _offset.y);
+}
+
+void VyRenderQueue::Quad(SDL_Texture* texture, const SDL_Rect& dest, SDL_FPoint uvMin, SDL_FPoint uvMax, SDL_Color tint, int layer, SDL_BlendMode blend) {
+	VyRenderCommand& command = Add(VyRenderCommand::Kind::TexturedQuad, texture, blend, layer);
+	command.color = tint;
+	command.x0 = (float)(dest.x + _offset.x);
+	command.y0 = (float)(dest.y + _offset.y);
+	command.x1 = (float)(dest.x + dest.w + _offset.x);
+	command.y1 = (float)(dest.y + dest.h + _offset.y);
+	command.uvMin = uvMin;
+	command.uvMax = uvMax;
+}
+
+void VyRenderQueue::Sprite(const VyAtlasSprite& sprite, const Rect& dest, SDL_Color tint, int layer) {
+	Quad(sprite.texture, dest, sprite.uvMin, sprite.uvMax, tint, layer);
+}
+
+void VyRenderQueue::Texture(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect& dest, int layer) {
+	if (texture == NULL) { return; }
+	SDL_FPoint uvMin = { 0, 0 }, uvMax = { 1, 1 };
+	if (source != NULL) {
+		int w, h;
+		SDL_QueryTexture(texture, NULL, NULL, &w, &h);
+		uvMin = { (float)source->x / w, (float)source->y / h };
+		uvMax = { (float)(source->x + source->w) / w, (float)(source->y + source->h) / h };
+	}
+	SDL_BlendMode blend = SDL_BLENDMODE_BLEND;
+	SDL_GetTextureBlendMode(texture, &blend);
+	Quad(texture, dest, uvMin, uvMax, { 0xFF, 0xFF, 0xFF, 0xFF }, layer, blend);
+}
+
+void VyRenderQueue::AppendGeometry(const VyRenderCommand& command) {
+	int first = (int)_vertices.size();
+	switch (command.kind) {
+	case VyRenderCommand::Kind::FillRect:
+		_vertices.push_back({ { command.x0, command.y0 }, command.color, { 0, 0 } });
+		_vertices.push_back({ { command.x1, command.y0 }, command.color, { 0, 0 } });
+		_vertices.push_back({ { command.x1, command.y1 }, command.color, { 0, 0 } });
+		_vertices.push_back({ { command.x0, command.y1 }, command.color, { 0, 0 } });
+		break;
+	case VyRenderCommand::Kind::Line:
+		VyPrimitiveBatch::AppendLineQuad(_vertices, _indices, command.x0, command.y0, command.x1, command.y1, command.color);
+		return;
+	case VyRenderCommand::Kind::TexturedQuad:
+		_vertices.push_back({ { command.x0, command.y0 }, command.color, { command.uvMin.x, command.uvMin.y } });
+		_vertices.push_back({ { command.x1, command.y0 }, command.color, { command.uvMax.x, command.uvMin.y } });
+		_vertices.push_back({ { command.x1, command.y1 }, command.color, { command.uvMax.x, command.uvMax.y } });
+		_vertices.push_back({ { command.x0, command.y1 }, command.color, { command.uvMin.x, command.uvMax.y } });
+		break;
+	}
+	int quad[] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+	_indices.insert(_indices.end(), quad, quad + 6);
+}
+
+void VyRenderQueue::Submit(SDL_Texture* texture, SDL_BlendMode blend, SDL_BlendMode& drawBlend) {
+	if (_indices.empty()) { return; }
+	// untextured geometry blends with the renderer's draw blend mode, textured with the texture's
+	if (texture == NULL) {
+		if (blend != drawBlend) {
+			SDL_SetRenderDrawBlendMode(_renderer, blend);
+			drawBlend = blend;
+		}
+	} else {
+		SDL_BlendMode textureBlend;
+		if (SDL_GetTextureBlendMode(texture, &textureBlend) == 0 && textureBlend != blend) {
+			SDL_SetTextureBlendMode(texture, blend);
+		}
+	}
+	SDL_RenderGeometry(_renderer, texture, _vertices.data(), (int)_vertices.size(), _indices.data(), (int)_indices.size());
+	++_drawCalls;
+	_vertices.clear();
+	_indices.clear();
+}
+
+void VyRenderQueue::Flush() {
+	if (_commands.empty()) { return; }
+	VY_PROFILE_ZONE("VyRenderQueue::Flush");
+	std::sort(_keys.begin(), _keys.end());
+	SDL_BlendMode originalBlend = SDL_BLENDMODE_NONE;
+	SDL_GetRenderDrawBlendMode(_renderer, &originalBlend);
+	SDL_BlendMode drawBlend = originalBlend;
+	SDL_Texture* texture = _commands[_keys[0] & IndexMask].texture;
+	SDL_BlendMode blend = _commands[_keys[0] & IndexMask].blend;
+	for (int i = 0; i < _keys.size(); ++i) {
+		const VyRenderCommand& command = _commands[_keys[i] & IndexMask];
+		if (command.texture != texture || command.blend != blend) {
+			Submit(texture, blend, drawBlend);
+			texture = command.texture;
+			blend = command.blend;
+		}
+		AppendGeometry(command);
+	}
+	Submit(texture, blend, drawBlend);
+	if (drawBlend != originalBlend) {
+		SDL_SetRenderDrawBlendMode(_renderer, originalBlend);
+	}
+	_commandCount += (int)_commands.size();
+	_commands.clear();
+	_keys.clear();
+	_textureOrder.clear();
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include <unordered_map>
+#include "rect.h"
+
+class VyAtlasSprite;
+
+/// <summary>
+/// one recorded draw. rects are left, top, right, bottom; lines are x0, y0, x1, y1
+/// </summary>
+class VyRenderCommand {
+public:
+	enum class Kind : Uint8 { FillRect, Line, TexturedQuad };
+	Kind kind;
+	SDL_BlendMode blend;
+	SDL_Texture* texture;
+	SDL_Color color;
+	float x0, y0, x1, y1;
+	SDL_FPoint uvMin, uvMax;
+};
+
+/// <summary>
+/// per-frame list of draw commands. <see cref="VyRenderQueue::Flush"/> sorts them by layer, then order, then texture, then blend mode,
+/// and merges each run with the same texture and blend mode into one SDL_RenderGeometry call.
+/// <see cref="VyEngine::Render"/> gives each drawable its own order, so drawables overlap as they do when drawn directly;
+/// only the commands of one drawable are reordered by texture
+/// </summary>
+class VyRenderQueue {
+private:
+	SDL_Renderer* _renderer;
+	std::vector<VyRenderCommand> _commands;
+	/// <summary>layer | order | texture order | blend | command index, so sorting the keys alone sorts the commands</summary>
+	std::vector<Uint64> _keys;
+	/// <summary>textures in order of first use this frame. 0 is no texture</summary>
+	std::unordered_map<SDL_Texture*, Uint32> _textureOrder;
+	std::vector<SDL_Vertex> _vertices;
+	std::vector<int> _indices;
+	int _drawCalls;
+	int _commandCount;
+	SDL_Point _offset;
+	Uint32 _order;
+public:
+	/// <summary>layers are clamped to -MaxLayer..MaxLayer</summary>
+	static const int MaxLayer = 0x7FF;
+	/// <summary>orders from 0 to MaxOrder; higher ones share MaxOrder</summary>
+	static const Uint32 MaxOrder = 0xFFFF;
+	VyRenderQueue(SDL_Renderer* renderer);
+	/// <summary>
+	/// added to everything recorded from now on, the camera's <see cref="VyCamera::GetDrawOffset"/> while <see cref="VyEngine::Render"/> runs
+	/// </summary>
+	void SetOffset(SDL_Point offset) { _offset = offset; }
+	SDL_Point GetOffset() const { return _offset; }
+	/// <summary>
+	/// within a layer, commands recorded from now on draw after those recorded with a lower order
+	/// </summary>
+	void SetOrder(Uint32 order) { _order = order < MaxOrder ? order : MaxOrder; }
+	Uint32 GetOrder() const { return _order; }
+	void FillRect(const SDL_Rect& rect, SDL_Color color, int layer = 0, SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+	/// <summary>
+	/// one pixel wide, like SDL_RenderDrawLine
+	/// </summary>
+	void Line(int x0, int y0, int x1, int y1, SDL_Color color, int layer = 0, SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+	void Quad(SDL_Texture* texture, const SDL_Rect& dest, SDL_FPoint uvMin, SDL_FPoint uvMax, SDL_Color tint, int layer = 0, SDL_BlendMode blend = SDL_BLENDMODE_BLEND);
+	void Sprite(const VyAtlasSprite& sprite, const Rect& dest, SDL_Color tint, int layer = 0);
+	/// <summary>
+	/// like SDL_RenderCopy
+	/// </summary>
+	/// <param name="source">NULL for the whole texture</param>
+	void Texture(SDL_Texture* texture, const SDL_Rect* source, const SDL_Rect& dest, int layer = 0);
+	/// <summary>
+	/// draws everything recorded since the last flush and empties the queue. the renderer's draw blend mode is restored after
+	/// </summary>
+	void Flush();
+	bool IsEmpty() const { return _commands.empty(); }
+	/// <summary>
+	/// SDL_RenderGeometry calls since <see cref="VyRenderQueue::ResetStats"/>
+	/// </summary>
+	int GetDrawCalls() const { return _drawCalls; }
+	int GetCommandCount() const { return _commandCount; }
+	void ResetStats() { _drawCalls = 0; _commandCount = 0; }
+	/// <summary>
+	/// the packed colors used with SDL_SetRenderDrawColor(SDL_Renderer*, long)
+	/// </summary>
+	static SDL_Color ToColor(long rgba) {
+		Uint8* c = (Uint8*)&rgba;
+		return { c[0], c[1], c[2], c[3] };
+	}
+private:
+	VyRenderCommand& Add(VyRenderCommand::Kind kind, SDL_Texture* texture, SDL_BlendMode blend, int layer);
+	void AppendGeometry(const VyRenderCommand& command);
+	void Submit(SDL_Texture* texture, SDL_BlendMode blend, SDL_BlendMode& drawBlend);
+};
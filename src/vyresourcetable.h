@@ -0,0 +1,141 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/// <summary>
+/// index into a <see cref="VyResourceTable"/> plus the generation of the slot when it was handed out.
+/// once the resource is freed the slot's generation moves on, so stale handles resolve to nothing instead of to a reused slot
+/// </summary>
+class VyResourceHandle {
+public:
+	Uint32 index;
+	/// <summary>0 is never a live generation</summary>
+	Uint32 generation;
+	VyResourceHandle() : index(0), generation(0) {}
+	VyResourceHandle(Uint32 index, Uint32 generation) : index(index), generation(generation) {}
+	bool IsNull() const { return generation == 0; }
+	bool operator==(const VyResourceHandle& o) const { return index == o.index && generation == o.generation; }
+	bool operator!=(const VyResourceHandle& o) const { return !(*this == o); }
+};
+
+/// <summary>
+/// reference counted resources behind generational handles. acquire, add-ref, release and get are O(1).
+/// resources may have a key (like a path and load parameters) so loading the same thing again shares it.
+/// the table doesn't know how to free T: <see cref="VyResourceTable::Release"/> reports when the last reference goes
+/// </summary>
+template<typename T>
+class VyResourceTable {
+private:
+	struct Slot {
+		T value;
+		Uint32 generation;
+		int references;
+		std::string key;
+		/// <summary>position in _live while alive</summary>
+		int livePosition;
+	};
+	std::vector<Slot> _slots;
+	std::vector<Uint32> _freeSlots;
+	/// <summary>indices of live slots, so visiting everything is O(live)</summary>
+	std::vector<Uint32> _live;
+	std::unordered_map<std::string, VyResourceHandle> _byKey;
+public:
+	/// <summary>
+	/// stores value with one reference
+	/// </summary>
+	/// <param name="key">"" for resources that can't be shared</param>
+	VyResourceHandle Acquire(const T& value, const std::string& key) {
+		Uint32 index;
+		if (!_freeSlots.empty()) {
+			index = _freeSlots.back();
+			_freeSlots.pop_back();
+		} else {
+			index = (Uint32)_slots.size();
+			_slots.push_back(Slot());
+			_slots[index].generation = 0;
+		}
+		Slot& slot = _slots[index];
+		slot.value = value;
+		// skip 0 when wrapping, it means null
+		slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+		slot.references = 1;
+		slot.key = key;
+		slot.livePosition = (int)_live.size();
+		_live.push_back(index);
+		VyResourceHandle handle(index, slot.generation);
+		if (key != "") {
+			_byKey[key] = handle;
+		}
+		return handle;
+	}
+
+	/// <returns>a new reference to the resource with this key, or a null handle</returns>
+	VyResourceHandle AcquireExisting(const std::string& key) {
+		auto found = _byKey.find(key);
+		if (found == _byKey.end()) { return VyResourceHandle(); }
+		AddReference(found->second);
+		return found->second;
+	}
+
+	bool IsValid(VyResourceHandle handle) const {
+		return handle.generation != 0 && handle.index < _slots.size() && _slots[handle.index].generation == handle.generation
+			&& _slots[handle.index].references > 0;
+	}
+
+	/// <returns>NULL for stale or null handles</returns>
+	const T* Get(VyResourceHandle handle) const {
+		return IsValid(handle) ? &_slots[handle.index].value : NULL;
+	}
+
+	void AddReference(VyResourceHandle handle) {
+		if (IsValid(handle)) {
+			++_slots[handle.index].references;
+		}
+	}
+
+	int GetReferences(VyResourceHandle handle) const {
+		return IsValid(handle) ? _slots[handle.index].references : 0;
+	}
+
+	/// <summary>
+	/// drops one reference. stale handles are ignored
+	/// </summary>
+	/// <returns>true if that was the last reference: out_value must now be freed by the caller, and the handle is dead</returns>
+	bool Release(VyResourceHandle handle, T& out_value) {
+		if (!IsValid(handle)) { return false; }
+		Slot& slot = _slots[handle.index];
+		if (--slot.references > 0) { return false; }
+		out_value = slot.value;
+		slot.value = T();
+		if (slot.key != "") {
+			_byKey.erase(slot.key);
+			slot.key.clear();
+		}
+		Uint32 moved = _live.back();
+		_live[slot.livePosition] = moved;
+		_slots[moved].livePosition = slot.livePosition;
+		_live.pop_back();
+		// new generation now, so the handle just released is stale even before the slot is reused
+		slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+		_freeSlots.push_back(handle.index);
+		return true;
+	}
+
+	int GetLiveCount() const { return (int)_live.size(); }
+
+	/// <summary>
+	/// calls freeValue for every live resource, whatever its references, then empties the table. O(live)
+	/// </summary>
+	template<typename Free>
+	void Clear(Free freeValue) {
+		for (int i = 0; i < _live.size(); ++i) {
+			freeValue(_slots[_live[i]].value);
+		}
+		_slots.clear();
+		_freeSlots.clear();
+		_live.clear();
+		_byKey.clear();
+	}
+};
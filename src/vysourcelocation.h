@@ -0,0 +1,19 @@
+#pragma once
+
+/// <summary>
+/// where something came from, as string literals the compiler already has: nothing is formatted or allocated.
+/// use <see cref="VY_HERE"/> to make one
+/// </summary>
+class VySourceLocation {
+public:
+	const char* file;
+	const char* function;
+	int line;
+	constexpr VySourceLocation() : file(""), function(""), line(0) {}
+	constexpr VySourceLocation(const char* file, const char* function, int line) : file(file), function(function), line(line) {}
+};
+
+/// <summary>
+/// the source location of the line it is written on
+/// </summary>
+#define VY_HERE VySourceLocation(__FILE__, __func__, __LINE__)
@@ -0,0 +1,40 @@
+#include "vyspritebatch.h"
+#include "vyatlas.h"
+#include "vyprofiler.h"
+
+static const SDL_Color White = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+VySpriteBatch::VySpriteBatch(SDL_Renderer* renderer) : _renderer(renderer), _texture(NULL), _vertices(), _indices(), _drawCalls(0), _sprites(0), _offset({ 0, 0 }) {
+	_vertices.reserve(4 * 256);
+	_indices.reserve(6 * 256);
+}
+
+void VySpriteBatch::Draw(const VyAtlasSprite& sprite, const Rect& dest) {
+	Draw(sprite, dest, White);
+}
+
+void VySpriteBatch::Draw(const VyAtlasSprite& sprite, const Rect& dest, SDL_Color tint) {
+	if (sprite.texture != _texture) {
+		Flush();
+		_texture = sprite.texture;
+	}
+	int x = dest.x + _offset.x, y = dest.y + _offset.y;
+	float left = (float)x, top = (float)y, right = (float)(x + dest.w), bottom = (float)(y + dest.h);
+	int first = (int)_vertices.size();
+	_vertices.push_back({ { left, top }, tint, { sprite.uvMin.x, sprite.uvMin.y } });
+	_vertices.push_back({ { right, top }, tint, { sprite.uvMax.x, sprite.uvMin.y } });
+	_vertices.push_back({ { right, bottom }, tint, { sprite.uvMax.x, sprite.uvMax.y } });
+	_vertices.push_back({ { left, bottom }, tint, { sprite.uvMin.x, sprite.uvMax.y } });
+	int quad[] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+	_indices.insert(_indices.end(), quad, quad + 6);
+	++_sprites;
+}
+
+void VySpriteBatch::Flush() {
+	if (_indices.empty()) { return; }
+	VY_PROFILE_ZONE("VySpriteBatch::Flush");
+	SDL_RenderGeometry(_renderer, _texture, _vertices.data(), (int)_vertices.size(), _indices.data(), (int)_indices.size());
+	++_drawCalls;
+	_vertices.clear();
+	_indices.clear();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "rect.h"
+
+class VyAtlasSprite;
+
+/// <summary>
+/// collects textured quads and submits each run of same-texture quads with a single SDL_RenderGeometry call.
+/// sprites from one <see cref="VyTextureAtlas"/> page batch together.
+/// the batch draws when the texture changes or on <see cref="VySpriteBatch::Flush"/>, so flush before drawing anything directly with the renderer
+/// </summary>
+class VySpriteBatch {
+private:
+	SDL_Renderer* _renderer;
+	SDL_Texture* _texture;
+	std::vector<SDL_Vertex> _vertices;
+	std::vector<int> _indices;
+	int _drawCalls;
+	int _sprites;
+	SDL_Point _offset;
+public:
+	VySpriteBatch(SDL_Renderer* renderer);
+	/// <summary>
+	/// added to everything drawn from now on, the camera's <see cref="VyCamera::GetDrawOffset"/> while <see cref="VyEngine::Render"/> runs
+	/// </summary>
+	void SetOffset(SDL_Point offset) { _offset = offset; }
+	SDL_Point GetOffset() const { return _offset; }
+	void Draw(const VyAtlasSprite& sprite, const Rect& dest);
+	void Draw(const VyAtlasSprite& sprite, const Rect& dest, SDL_Color tint);
+	void Flush();
+	/// <summary>
+	/// SDL_RenderGeometry calls since <see cref="VySpriteBatch::ResetStats"/>
+	/// </summary>
+	int GetDrawCalls() const { return _drawCalls; }
+	int GetSpriteCount() const { return _sprites; }
+	void ResetStats() { _drawCalls = 0; _sprites = 0; }
+};